@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** A 64-byte record, the typical payload of our queues.
+ */
+struct Payload {
+    unsigned long long values[8]{};
+};
+
+/** Run a set of threads which start together and report the elapsed time.
+ *
+ *  @arg routines - the routine of each thread.
+ *
+ *  @return the seconds between the start signal and the last thread finishing.
+ */
+template<typename RoutineT>
+double runThreads(std::vector<RoutineT>& routines) {
+
+    std::atomic_bool start{ false };
+    std::vector<std::thread> threads{};
+
+    for (auto& routine : routines) {
+        threads.emplace_back([&start, &routine]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            routine();
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+/** Print a result row.
+ *
+ *  @arg name - what was measured.
+ *  @arg threads - the number of threads used.
+ *  @arg operations - the number of operations performed.
+ *  @arg seconds - the elapsed time.
+ */
+inline void report(const std::string& name, size_t threads, unsigned long long operations, double seconds) {
+    std::cout << std::left << std::setw(40) << name
+              << " threads: " << std::setw(4) << threads
+              << " Mops/s: " << std::fixed << std::setprecision(2) << (operations / seconds / 1e6)
+              << std::endl;
+}
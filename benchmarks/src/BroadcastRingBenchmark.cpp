@@ -0,0 +1,90 @@
+#include <BroadcastRing.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1000000 };
+
+double benchmarkBroadcastRing(size_t numberOfConsumers) {
+
+    auto ring = std::make_unique<BroadcastRing<Payload, 1024>>(numberOfConsumers);
+    std::vector<std::function<void()>> routines{};
+
+    routines.emplace_back([&ring]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < totalItems; ++i) {
+            payload.values[0] = i;
+            while (!ring->push(payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&ring, consumer]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < totalItems; ) {
+                if (ring->pop(consumer, payload)) {
+                    ++i;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+double benchmarkSeparateQueues(size_t numberOfConsumers) {
+
+    using QueueT = LockFreeQueue<Payload, 1024>;
+
+    std::vector<std::unique_ptr<QueueT>> queues{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        queues.push_back(std::make_unique<QueueT>(2));
+    }
+
+    std::vector<std::function<void()>> routines{};
+
+    routines.emplace_back([&queues]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < totalItems; ++i) {
+            payload.values[0] = i;
+            for (auto& queue : queues) { // One copy per consumer.
+                while (!queue->push(payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&queue = *queues.at(consumer)]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < totalItems; ) {
+                if (queue.pop(payload)) {
+                    ++i;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    std::cout << "Items delivered to every consumer: " << totalItems << std::endl;
+
+    for (size_t numberOfConsumers : { 1, 2, 4, 8 }) {
+        report("BroadcastRing", numberOfConsumers + 1, totalItems, benchmarkBroadcastRing(numberOfConsumers));
+        report("LockFreeQueue per consumer", numberOfConsumers + 1, totalItems, benchmarkSeparateQueues(numberOfConsumers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <ConflatingQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1 << 20 };
+const unsigned long long numberOfKeys{ 64 };
+
+/** Producers sending updates for a small set of keys to one consumer, as a price feed does.
+ *
+ *  Both queues are given the updates; the LockFreeQueue consumer pops every
+ *  one of them, the ConflatingQueue consumer only the latest of each key.
+ */
+template<typename QueueT, typename ItemT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers) {
+
+    unsigned long long itemsPerProducer = totalItems / numberOfProducers;
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, &producing, itemsPerProducer]() {
+            ItemT item{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                item.first = i % numberOfKeys;
+                item.second.values[0] = i;
+                while (!queue.push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    routines.emplace_back([&queue, &producing]() {
+        ItemT item{};
+        while (true) {
+            bool done = producing.load(std::memory_order_acquire) == 0;
+            if (!queue.pop(item)) {
+                if (done) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    using Update = std::pair<unsigned long long, Payload>;
+
+    for (size_t numberOfProducers : { 1, 2, 4, 8, 16, 32 }) {
+
+        auto current = std::make_unique<LockFreeQueue<Update, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue (MpmcQueue)", numberOfProducers + 1, totalItems,
+               benchmarkQueue<LockFreeQueue<Update, 1024>, Update>(*current, numberOfProducers));
+
+        auto conflating = std::make_unique<ConflatingQueue<unsigned long long, Payload, numberOfKeys>>();
+        report("ConflatingQueue", numberOfProducers + 1, totalItems,
+               benchmarkQueue<ConflatingQueue<unsigned long long, Payload, numberOfKeys>, Update>(*conflating, numberOfProducers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1000000 };
+const size_t bufferSize{ 1 << 16 }; // 4MB of 64-byte records, larger than most L2 caches.
+
+using QueueT = LockFreeQueue<Payload, bufferSize>;
+
+template<typename PopT>
+double benchmarkQueue(QueueT& queue, size_t numberOfConsumers, PopT popRoutine) {
+
+    std::atomic<unsigned long long> remaining{ totalItems };
+    std::vector<std::function<void()>> routines{};
+
+    routines.emplace_back([&queue]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < totalItems; ++i) {
+            payload.values[0] = i;
+            while (!queue.push(payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&queue, &remaining, popRoutine]() {
+            popRoutine(queue, remaining);
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfConsumers : { 1, 2, 4 }) {
+
+        auto direct = std::make_unique<QueueT>(numberOfConsumers + 1);
+        report("LockFreeQueue pop", numberOfConsumers + 1, totalItems,
+               benchmarkQueue(*direct, numberOfConsumers, [](QueueT& queue, std::atomic<unsigned long long>& remaining) {
+                   Payload payload{};
+                   while (remaining.load(std::memory_order_relaxed) != 0) {
+                       if (queue.pop(payload)) {
+                           remaining.fetch_sub(1, std::memory_order_relaxed);
+                       }
+                       else {
+                           std::this_thread::yield();
+                       }
+                   }
+               }));
+
+        auto claimed = std::make_unique<QueueT>(numberOfConsumers + 1);
+        report("ConsumerHandle (batch 32)", numberOfConsumers + 1, totalItems,
+               benchmarkQueue(*claimed, numberOfConsumers, [](QueueT& queue, std::atomic<unsigned long long>& remaining) {
+                   auto handle = queue.consumerHandle(32);
+                   Payload payload{};
+                   while (remaining.load(std::memory_order_relaxed) != 0) {
+                       if (handle.pop(payload)) {
+                           remaining.fetch_sub(1, std::memory_order_relaxed);
+                       }
+                       else {
+                           std::this_thread::yield();
+                       }
+                   }
+               }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long itemsPerProducer{ 200000 };
+
+/** Run producers and as many consumers polling the queue, so it stays near empty.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfThreads) {
+
+    std::atomic<unsigned long long> remaining{ itemsPerProducer * numberOfThreads };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfThreads; ++producer) {
+        routines.emplace_back([&queue]() {
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfThreads; ++consumer) {
+        routines.emplace_back([&queue, &remaining]() {
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.pop(data)) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfThreads : { 1, 2, 4, 8, 16 }) {
+
+        auto queue = std::make_unique<MpmcQueue<unsigned long long, 1024>>(2 * numberOfThreads);
+
+        report("MpmcQueue (near empty)", 2 * numberOfThreads, itemsPerProducer * numberOfThreads,
+               benchmarkQueue(*queue, numberOfThreads));
+        std::cout << "    eliminated: " << queue->eliminations() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <EpochReclamation.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long nodesPerThread{ 1000000 };
+
+/** The cost of freeing a node right away, the baseline of retire + reclaim.
+ */
+double benchmarkDelete(size_t numberOfThreads) {
+
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t thread = 0; thread < numberOfThreads; ++thread) {
+        routines.emplace_back([]() {
+            for (unsigned long long i = 0; i < nodesPerThread; ++i) {
+                Payload* volatile node = new Payload{}; // volatile, so the allocation is not optimised away.
+                delete node;
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+/** The cost of retiring a node inside a pinned section and freeing it later, in batches.
+ */
+template<size_t hazardPointers>
+double benchmarkRetire(size_t numberOfThreads, size_t batchSize) {
+
+    EpochReclamation<hazardPointers> domain{ numberOfThreads, batchSize };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t thread = 0; thread < numberOfThreads; ++thread) {
+        routines.emplace_back([&domain]() {
+            auto participant = domain.join();
+            for (unsigned long long i = 0; i < nodesPerThread; ++i) {
+                auto guard = participant.pin();
+                participant.retire(new Payload{});
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfThreads : { 1, 2, 4, 8 }) {
+
+        unsigned long long totalNodes = nodesPerThread * numberOfThreads;
+
+        report("delete", numberOfThreads, totalNodes, benchmarkDelete(numberOfThreads));
+
+        for (size_t batchSize : { 16, 64, 256 }) {
+            report("pin + retire (batch " + std::to_string(batchSize) + ")", numberOfThreads, totalNodes,
+                   benchmarkRetire<0>(numberOfThreads, batchSize));
+        }
+
+        report("pin + retire (batch 64, 2 hazards)", numberOfThreads, totalNodes, benchmarkRetire<2>(numberOfThreads, 64));
+    }
+
+    return 0;
+}
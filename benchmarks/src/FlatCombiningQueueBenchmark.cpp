@@ -0,0 +1,63 @@
+#include <FlatCombiningQueue.h>
+#include <ScqQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1 << 20 };
+
+/** Run the same small-item workload with an increasing number of producers and consumers.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers, size_t numberOfConsumers) {
+
+    unsigned long long itemsPerProducer = totalItems / numberOfProducers;
+    std::atomic<unsigned long long> remaining{ itemsPerProducer * numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, itemsPerProducer]() {
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&queue, &remaining]() {
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.pop(data)) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfThreads : { 1, 2, 4, 8, 16 }) {
+
+        auto current = std::make_unique<LockFreeQueue<unsigned long long, 1024>>(2 * numberOfThreads);
+        report("LockFreeQueue (MpmcQueue)", 2 * numberOfThreads, totalItems,
+               benchmarkQueue(*current, numberOfThreads, numberOfThreads));
+
+        auto scq = std::make_unique<ScqQueue<unsigned long long, 1024>>();
+        report("ScqQueue", 2 * numberOfThreads, totalItems,
+               benchmarkQueue(*scq, numberOfThreads, numberOfThreads));
+
+        auto combining = std::make_unique<FlatCombiningQueue<unsigned long long, 1024>>(2 * numberOfThreads);
+        report("FlatCombiningQueue", 2 * numberOfThreads, totalItems,
+               benchmarkQueue(*combining, numberOfThreads, numberOfThreads));
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <algorithm>
+#include <csignal>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/time.h>
+
+const unsigned long long itemsPerProducer{ 100000 };
+
+thread_local bool isProducer{ false };
+
+/** Put the running thread to sleep if it is a producer, wherever it is in its push.
+ */
+void stallProducer(int) {
+    if (isProducer) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+}
+
+/** Oversubscribe the CPUs with producers and consumers of large items.
+ *
+ *  With more threads than cores, producers get preempted in the middle of
+ *  their copies, which is when consumers find the head index in flight.
+ *
+ *  @arg latencies - set to the duration of every successful pop, in nanoseconds, sorted.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfThreads, std::vector<long long>& latencies) {
+
+    std::atomic<unsigned long long> remaining{ itemsPerProducer * numberOfThreads };
+    std::mutex mutex{};
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfThreads; ++producer) {
+        routines.emplace_back([&queue]() {
+            isProducer = true;
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                while (!queue.push(payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfThreads; ++consumer) {
+        routines.emplace_back([&queue, &remaining, &mutex, &latencies]() {
+            std::vector<long long> own{};
+            Payload payload{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                auto begin = std::chrono::steady_clock::now();
+                if (queue.pop(payload)) {
+                    own.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::lock_guard lock{ mutex };
+            latencies.insert(latencies.end(), own.begin(), own.end());
+        });
+    }
+
+    double seconds = runThreads(routines);
+
+    std::sort(latencies.begin(), latencies.end());
+
+    return seconds;
+}
+
+int main() {
+    for (bool stalled : { false, true }) {
+
+        if (stalled) { // Every 5ms of CPU time, a producer running then sleeps for 1ms.
+            std::signal(SIGPROF, stallProducer);
+            itimerval period{ { 0, 5000 }, { 0, 5000 } };
+            setitimer(ITIMER_PROF, &period, nullptr);
+        }
+
+        for (size_t numberOfThreads : { 2, 8, 32 }) {
+
+            auto queue = std::make_unique<LockFreeQueue<Payload, 1024>>(2 * numberOfThreads);
+
+            std::vector<long long> latencies{};
+            report(stalled ? "LockFreeQueue (stalled producers)" : "LockFreeQueue (oversubscribed)", 2 * numberOfThreads,
+                   itemsPerProducer * numberOfThreads, benchmarkQueue(*queue, numberOfThreads, latencies));
+
+            auto percentile = [&latencies](double fraction) {
+                return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+            };
+
+            auto stalls = queue->stallStatistics();
+            std::cout << "    stalls: " << stalls.count
+                      << " total us: " << stalls.total.count() / 1000
+                      << " longest us: " << stalls.longest.count() / 1000 << std::endl;
+            std::cout << "    pop latency ns p50: " << percentile(0.5)
+                      << " p99: " << percentile(0.99)
+                      << " p99.99: " << percentile(0.9999)
+                      << " max: " << latencies.back() << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <MichaelScottQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const size_t burstsPerProducer{ 200 };
+const size_t burstSizes[]{ 16, 256, 4096, 64 }; // unpredictable bursts, the largest ones overflow the ring
+
+/** Push bursts with pauses between them, while the consumers drain.
+ *
+ *  A push which fails is dropped rather than retried, the way a producer
+ *  which cannot wait would behave, and counted.
+ *
+ *  @arg dropped - the number of dropped items.
+ *
+ *  @return the elapsed time.
+ */
+template<typename PushT, typename PopT>
+double benchmarkQueue(size_t numberOfProducers, size_t numberOfConsumers, PushT push, PopT pop,
+                      std::atomic<unsigned long long>& dropped) {
+
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&producing, &dropped, push]() {
+            Payload payload{};
+            unsigned long long failed{ 0 };
+            for (size_t burst = 0; burst < burstsPerProducer; ++burst) {
+                for (size_t i = 0; i < burstSizes[burst % std::size(burstSizes)]; ++i) {
+                    payload.values[0] = i;
+                    failed += push(payload) ? 0 : 1;
+                }
+                std::this_thread::yield(); // The pause between bursts.
+            }
+            dropped.fetch_add(failed, std::memory_order_relaxed);
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&producing, pop]() {
+            Payload payload{};
+            while (true) {
+                if (pop(payload)) {
+                    continue;
+                }
+                if (producing.load(std::memory_order_acquire) == 0 && !pop(payload)) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+unsigned long long totalItems(size_t numberOfProducers) {
+    unsigned long long items{ 0 };
+    for (size_t burst = 0; burst < burstsPerProducer; ++burst) {
+        items += burstSizes[burst % std::size(burstSizes)];
+    }
+    return items * numberOfProducers;
+}
+
+int main() {
+    for (size_t numberOfThreads : { 1, 2, 4 }) {
+
+        unsigned long long items = totalItems(numberOfThreads);
+
+        std::atomic<unsigned long long> ringDropped{ 0 };
+        auto ring = std::make_unique<LockFreeQueue<Payload, 1024>>(2 * numberOfThreads);
+        report("LockFreeQueue (1024 ring)", 2 * numberOfThreads, items,
+               benchmarkQueue(numberOfThreads, numberOfThreads,
+                              [&ring](const Payload& payload) { return ring->push(payload); },
+                              [&ring](Payload& payload) { return ring->pop(payload); },
+                              ringDropped));
+        std::cout << "    dropped: " << ringDropped.load() << " of " << items << std::endl;
+
+        std::atomic<unsigned long long> nodesDropped{ 0 };
+        auto nodes = std::make_unique<MichaelScottQueue<Payload>>(2 * numberOfThreads);
+        report("MichaelScottQueue", 2 * numberOfThreads, items,
+               benchmarkQueue(numberOfThreads, numberOfThreads,
+                              [&nodes](const Payload& payload) { return nodes->push(payload); },
+                              [&nodes](Payload& payload) { return nodes->pop(payload); },
+                              nodesDropped));
+        std::cout << "    dropped: " << nodesDropped.load() << " of " << items << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long itemsPerProducer{ 200000 };
+
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers) {
+
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                while (!queue.push(payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    routines.emplace_back([&queue, numberOfProducers]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < itemsPerProducer * numberOfProducers; ) {
+            if (queue.pop(payload)) {
+                ++i;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfProducers : { 1, 2, 4, 8, 16, 32 }) {
+        unsigned long long totalItems = itemsPerProducer * numberOfProducers;
+
+        auto mpsc = std::make_unique<LockFreeQueue<Payload, 1024, Producers::Multi, Consumers::Single>>(numberOfProducers + 1);
+        report("LockFreeQueue (MPSC)", numberOfProducers + 1, totalItems, benchmarkQueue(*mpsc, numberOfProducers));
+
+        auto mpmc = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue (MPMC)", numberOfProducers + 1, totalItems, benchmarkQueue(*mpmc, numberOfProducers));
+    }
+
+    return 0;
+}
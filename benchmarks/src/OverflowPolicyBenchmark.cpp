@@ -0,0 +1,86 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+const unsigned long long totalItems{ 1 << 20 };
+
+/** Overloaded producers against one consumer which does some work per item.
+ *
+ *  The baseline producers retry a failing push, the others offer once and
+ *  let the overflow policy decide.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers, bool retry) {
+
+    unsigned long long itemsPerProducer = totalItems / numberOfProducers;
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, &producing, itemsPerProducer, retry]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                if (retry) {
+                    while (!queue.push(payload)) {
+                        std::this_thread::yield();
+                    }
+                }
+                else {
+                    queue.offer(payload);
+                }
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    routines.emplace_back([&queue, &producing]() {
+        Payload payload{};
+        unsigned long long work{ 0 };
+        while (producing.load(std::memory_order_acquire) != 0 || queue.hasData()) {
+            if (!queue.pop(payload)) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (unsigned long long i = 0; i < 64; ++i) { // The consumer is the bottleneck.
+                work += payload.values[0] * i;
+            }
+        }
+        payload.values[1] = work;
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    const std::pair<const char*, OverflowPolicy> policies[]{
+        { "LockFreeQueue (DropNewest)", { OverflowAction::DropNewest } },
+        { "LockFreeQueue (DropOldest)", { OverflowAction::DropOldest } },
+        { "LockFreeQueue (EarlyDrop)", { OverflowAction::EarlyDrop, std::chrono::nanoseconds{ 0 }, 0.5 } },
+        { "LockFreeQueue (Block)", { OverflowAction::Block, std::chrono::milliseconds{ 100 } } }
+    };
+
+    for (size_t numberOfProducers : { 1, 2, 4, 8, 16, 32 }) {
+
+        auto retrying = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue (push retry loop)", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*retrying, numberOfProducers, true));
+
+        for (const auto& [name, policy] : policies) {
+
+            auto queue = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+            queue->setOverflowPolicy(policy);
+
+            report(name, numberOfProducers + 1, totalItems,
+                   benchmarkQueue(*queue, numberOfProducers, false));
+
+            OverflowStatistics statistics = queue->overflowStatistics();
+            std::cout << "    dropped: " << statistics.droppedNewest + statistics.droppedOldest + statistics.droppedEarly
+                      << "  blocked: " << statistics.blocked << "  timed out: " << statistics.timedOut << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <OverwriteRing.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1 << 20 };
+
+/** Producers which never retry, as on a sampling hot path, against one consumer.
+ *
+ *  The LockFreeQueue producers drop the data a full queue rejects, the
+ *  OverwriteRing ones drop the oldest data instead.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers) {
+
+    unsigned long long itemsPerProducer = totalItems / numberOfProducers;
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, &producing, itemsPerProducer]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                queue.push(payload);
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    routines.emplace_back([&queue, &producing]() {
+        Payload payload{};
+        while (producing.load(std::memory_order_acquire) != 0 || queue.hasData()) {
+            if (!queue.pop(payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfProducers : { 1, 2, 4, 8, 16, 32 }) {
+
+        auto current = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue (MpmcQueue)", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*current, numberOfProducers));
+
+        auto ring = std::make_unique<OverwriteRing<Payload, 1024>>();
+        report("OverwriteRing", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*ring, numberOfProducers));
+    }
+
+    return 0;
+}
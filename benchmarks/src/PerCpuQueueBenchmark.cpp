@@ -0,0 +1,58 @@
+#include <PerCpuQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1 << 20 };
+
+/** Many producers feeding one consumer, the shape of a log or telemetry sink.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers) {
+
+    unsigned long long itemsPerProducer = totalItems / numberOfProducers;
+    std::atomic<unsigned long long> remaining{ itemsPerProducer * numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, itemsPerProducer]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                while (!queue.push(payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    routines.emplace_back([&queue, &remaining]() {
+        Payload payload{};
+        while (remaining.load(std::memory_order_relaxed) != 0) {
+            if (queue.pop(payload)) {
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfProducers : { 1, 2, 4, 8, 16, 32 }) {
+
+        auto current = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue (MpmcQueue)", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*current, numberOfProducers));
+
+        auto perCpu = std::make_unique<PerCpuQueue<Payload, 1024>>();
+        report("PerCpuQueue", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*perCpu, numberOfProducers));
+    }
+
+    return 0;
+}
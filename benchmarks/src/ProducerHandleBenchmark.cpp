@@ -0,0 +1,65 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1000000 };
+
+template<typename PushT>
+double benchmarkQueue(LockFreeQueue<Payload, 1024>& queue, size_t numberOfProducers, PushT pushRoutine) {
+
+    std::atomic<unsigned long long> remaining{ totalItems };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, numberOfProducers, pushRoutine]() {
+            pushRoutine(queue, totalItems / numberOfProducers);
+        });
+    }
+
+    routines.emplace_back([&queue, &remaining]() {
+        Payload payload{};
+        while (remaining.load(std::memory_order_relaxed) != 0) {
+            if (queue.pop(payload)) {
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfProducers : { 1, 2, 4, 8 }) {
+
+        auto direct = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("LockFreeQueue push", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*direct, numberOfProducers, [](LockFreeQueue<Payload, 1024>& queue, unsigned long long items) {
+                   Payload payload{};
+                   for (unsigned long long i = 0; i < items; ++i) {
+                       payload.values[0] = i;
+                       while (!queue.push(payload)) {
+                           std::this_thread::yield();
+                       }
+                   }
+               }));
+
+        auto staged = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfProducers + 1);
+        report("ProducerHandle (batch 32)", numberOfProducers + 1, totalItems,
+               benchmarkQueue(*staged, numberOfProducers, [](LockFreeQueue<Payload, 1024>& queue, unsigned long long items) {
+                   auto handle = queue.producerHandle(32, std::chrono::microseconds{ 100 });
+                   Payload payload{};
+                   for (unsigned long long i = 0; i < items; ++i) {
+                       payload.values[0] = i;
+                       while (!handle.push(payload)) {
+                           std::this_thread::yield();
+                       }
+                   }
+               }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+const unsigned long long totalItems{ 1000000 };
+
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfProducers, size_t numberOfConsumers) {
+
+    std::atomic<unsigned long long> remaining{ totalItems };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([&queue, numberOfProducers]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < totalItems / numberOfProducers; ++i) {
+                payload.values[0] = i;
+                while (!queue.push(payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&queue, &remaining]() {
+            Payload payload{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.pop(payload)) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+/** Build an engine on its own, as LockFreeQueue would.
+ *
+ *  @arg threads - the total number of consumer+producer threads, only the MPMC engine uses it.
+ */
+template<typename EngineT>
+std::unique_ptr<EngineT> makeEngine(size_t threads) {
+    if constexpr (std::is_same_v<EngineT, MpmcQueue<Payload, 1024>>) {
+        return std::make_unique<EngineT>(threads);
+    }
+    else {
+        return std::make_unique<EngineT>();
+    }
+}
+
+/** Push and pop batches of 32 items from a single thread.
+ *
+ *  Without contention, the cost of the front end over its engine is what
+ *  is left to measure.
+ */
+template<typename QueueT>
+double benchmarkUncontended(QueueT& queue) {
+
+    const size_t batchSize{ 32 };
+
+    std::vector<std::function<void()>> routines{};
+
+    routines.emplace_back([&queue, batchSize]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < totalItems; i += batchSize) {
+            for (size_t item = 0; item < batchSize; ++item) {
+                payload.values[0] = i + item;
+                queue.push(payload);
+            }
+            for (size_t item = 0; item < batchSize; ++item) {
+                queue.pop(payload);
+            }
+        }
+    });
+
+    return runThreads(routines);
+}
+
+/** Run the same one-to-one, many-to-one and one-to-many workloads through
+ *  the default (MPMC) queue, through the queue of the matching topology and
+ *  through the engine the latter is built on.
+ */
+template<typename ProducersT, typename ConsumersT, typename EngineT>
+void benchmarkTopology(const std::string& topology, size_t numberOfProducers, size_t numberOfConsumers) {
+
+    size_t threads{ numberOfProducers + numberOfConsumers };
+
+    auto mpmc = std::make_unique<LockFreeQueue<Payload, 1024>>(threads);
+    report(topology + " as MPMC", threads, totalItems, benchmarkQueue(*mpmc, numberOfProducers, numberOfConsumers));
+
+    auto selected = std::make_unique<LockFreeQueue<Payload, 1024, ProducersT, ConsumersT>>(threads);
+    report(topology, threads, totalItems, benchmarkQueue(*selected, numberOfProducers, numberOfConsumers));
+
+    auto engine = makeEngine<EngineT>(threads);
+    report(topology + " engine alone", threads, totalItems, benchmarkQueue(*engine, numberOfProducers, numberOfConsumers));
+}
+
+/** Compare the front end of a topology with its engine, on a single thread.
+ */
+template<typename ProducersT, typename ConsumersT, typename EngineT>
+void benchmarkFrontEnd(const std::string& topology) {
+
+    auto selected = std::make_unique<LockFreeQueue<Payload, 1024, ProducersT, ConsumersT>>(1);
+    report(topology + " uncontended", 1, 2 * totalItems, benchmarkUncontended(*selected));
+
+    auto engine = makeEngine<EngineT>(1);
+    report(topology + " engine alone, uncontended", 1, 2 * totalItems, benchmarkUncontended(*engine));
+}
+
+int main() {
+    benchmarkFrontEnd<Producers::Multi, Consumers::Multi, MpmcQueue<Payload, 1024>>("MPMC");
+    benchmarkFrontEnd<Producers::Multi, Consumers::Single, MpscQueue<Payload, 1024>>("MPSC");
+    benchmarkFrontEnd<Producers::Single, Consumers::Multi, SpmcQueue<Payload, 1024>>("SPMC");
+    benchmarkFrontEnd<Producers::Single, Consumers::Single, SpscQueue<Payload, 1024>>("SPSC");
+
+    benchmarkTopology<Producers::Single, Consumers::Single, SpscQueue<Payload, 1024>>("SPSC", 1, 1);
+
+    for (size_t numberOfThreads : { 2, 4, 8 }) {
+        benchmarkTopology<Producers::Multi, Consumers::Single, MpscQueue<Payload, 1024>>("MPSC", numberOfThreads, 1);
+        benchmarkTopology<Producers::Single, Consumers::Multi, SpmcQueue<Payload, 1024>>("SPMC", 1, numberOfThreads);
+    }
+
+    return 0;
+}
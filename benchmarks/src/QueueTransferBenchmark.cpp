@@ -0,0 +1,52 @@
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const size_t bufferSize{ 1 << 16 };
+const size_t rounds{ 20 };
+
+using QueueT = LockFreeQueue<Payload, bufferSize>;
+
+/** Move a full backlog from one queue to another, back and forth.
+ */
+template<typename MoveT>
+double benchmarkTransfer(MoveT move) {
+
+    auto source = std::make_unique<QueueT>(1);
+    auto target = std::make_unique<QueueT>(1);
+
+    Payload payload{};
+    for (size_t i = 0; i < bufferSize - 1; ++i) {
+        payload.values[0] = i;
+        source->push(payload);
+    }
+
+    std::vector<std::function<void()>> routines{};
+    routines.emplace_back([&source, &target, move]() {
+        for (size_t round = 0; round < rounds; ++round) {
+            move(*source, *target);
+            std::swap(source, target);
+        }
+    });
+
+    return runThreads(routines);
+}
+
+int main() {
+
+    const unsigned long long items{ (bufferSize - 1) * rounds };
+
+    report("pop/push", 1, items, benchmarkTransfer([](QueueT& source, QueueT& target) {
+        Payload payload{};
+        while (source.pop(payload)) {
+            target.push(payload);
+        }
+    }));
+
+    report("drainInto", 1, items, benchmarkTransfer([](QueueT& source, QueueT& target) {
+        source.drainInto(target, bufferSize);
+    }));
+
+    return 0;
+}
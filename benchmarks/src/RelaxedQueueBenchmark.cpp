@@ -0,0 +1,67 @@
+#include <RelaxedQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long itemsPerProducer{ 200000 };
+
+/** Run the same workload through the strict and the relaxed queue.
+ *
+ *  The strict queue ignores the producer/consumer ids.
+ */
+template<typename PushT, typename PopT>
+double benchmarkQueue(size_t numberOfProducers, size_t numberOfConsumers, PushT push, PopT pop) {
+
+    std::atomic<unsigned long long> remaining{ itemsPerProducer * numberOfProducers };
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        routines.emplace_back([producer, push]() {
+            Payload payload{};
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                payload.values[0] = i;
+                while (!push(producer, payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([consumer, &remaining, pop]() {
+            Payload payload{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (pop(consumer, payload)) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfThreads : { 1, 2, 4, 8 }) {
+
+        unsigned long long totalItems = itemsPerProducer * numberOfThreads;
+
+        auto strict = std::make_unique<LockFreeQueue<Payload, 1024>>(2 * numberOfThreads);
+        report("LockFreeQueue (strict)", 2 * numberOfThreads, totalItems,
+               benchmarkQueue(numberOfThreads, numberOfThreads,
+                              [&strict](size_t, const Payload& payload) { return strict->push(payload); },
+                              [&strict](size_t, Payload& payload) { return strict->pop(payload); }));
+
+        auto relaxed = std::make_unique<RelaxedQueue<Payload, 1024>>(numberOfThreads);
+        report("RelaxedQueue", 2 * numberOfThreads, totalItems,
+               benchmarkQueue(numberOfThreads, numberOfThreads,
+                              [&relaxed](size_t producer, const Payload& payload) { return relaxed->push(producer, payload); },
+                              [&relaxed](size_t consumer, Payload& payload) { return relaxed->pop(consumer, payload); }));
+    }
+
+    return 0;
+}
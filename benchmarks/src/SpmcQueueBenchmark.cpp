@@ -0,0 +1,53 @@
+#include <SpmcQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <functional>
+#include <memory>
+
+const unsigned long long totalItems{ 1000000 };
+
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfConsumers) {
+
+    std::atomic<unsigned long long> remaining{ totalItems };
+    std::vector<std::function<void()>> routines{};
+
+    routines.emplace_back([&queue]() {
+        Payload payload{};
+        for (unsigned long long i = 0; i < totalItems; ++i) {
+            payload.values[0] = i;
+            while (!queue.push(payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        routines.emplace_back([&queue, &remaining]() {
+            Payload payload{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.pop(payload)) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    return runThreads(routines);
+}
+
+int main() {
+    for (size_t numberOfConsumers : { 2, 4, 8, 16, 32 }) {
+
+        auto spmc = std::make_unique<SpmcQueue<Payload, 1024>>();
+        report("SpmcQueue", numberOfConsumers + 1, totalItems, benchmarkQueue(*spmc, numberOfConsumers));
+
+        auto mpmc = std::make_unique<LockFreeQueue<Payload, 1024>>(numberOfConsumers + 1);
+        report("LockFreeQueue", numberOfConsumers + 1, totalItems, benchmarkQueue(*mpmc, numberOfConsumers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <WaitFreeQueue.h>
+#include <MichaelScottQueue.h>
+#include <LockFreeQueue.h>
+#include <Benchmark.h>
+#include <algorithm>
+#include <csignal>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/time.h>
+
+const size_t operationsPerThread{ 50000 };
+
+/** Time every operation of threads which all push then pop, oversubscribing the CPUs.
+ *
+ *  With more threads than cores the scheduler preempts threads in the
+ *  middle of their operations, the adversarial case for retry loops.
+ *
+ *  @arg latencies - set to the duration of every operation, in nanoseconds, sorted.
+ */
+template<typename QueueT>
+double benchmarkQueue(QueueT& queue, size_t numberOfThreads, std::vector<long long>& latencies) {
+
+    std::mutex mutex{};
+    std::vector<std::function<void()>> routines{};
+
+    for (size_t thread = 0; thread < numberOfThreads; ++thread) {
+        routines.emplace_back([&queue, &mutex, &latencies]() {
+            std::vector<long long> own{};
+            own.reserve(2 * operationsPerThread);
+
+            unsigned long long data{};
+            for (size_t i = 0; i < operationsPerThread; ++i) {
+
+                auto begin = std::chrono::steady_clock::now();
+                while (!queue.push(i)) {} // Never full with one item per thread.
+                auto pushed = std::chrono::steady_clock::now();
+                while (!queue.pop(data)) {} // Never empty, every thread pushed first.
+                auto poped = std::chrono::steady_clock::now();
+
+                own.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(pushed - begin).count());
+                own.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(poped - pushed).count());
+            }
+
+            std::lock_guard lock{ mutex };
+            latencies.insert(latencies.end(), own.begin(), own.end());
+        });
+    }
+
+    double seconds = runThreads(routines);
+
+    std::sort(latencies.begin(), latencies.end());
+
+    return seconds;
+}
+
+void reportLatencies(const std::vector<long long>& latencies) {
+    auto percentile = [&latencies](double fraction) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+    };
+
+    std::cout << "    latency ns p50: " << percentile(0.5)
+              << " p99: " << percentile(0.99)
+              << " p99.99: " << percentile(0.9999)
+              << " max: " << latencies.back() << std::endl;
+}
+
+/** Put the running thread to sleep, wherever it is, as a preemption would.
+ */
+void stallThread(int) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+}
+
+/** Run the benchmark, optionally stalling a thread for 1ms every 5ms of CPU time.
+ *
+ *  A stalled thread delays its own operation, whatever the queue. The
+ *  other threads keep their latency only if the queue lets them get past
+ *  an operation left half done.
+ */
+template<typename QueueT>
+void run(const char* name, QueueT& queue, size_t numberOfThreads, bool stalled) {
+
+    if (stalled) {
+        std::signal(SIGPROF, stallThread);
+        itimerval period{ { 0, 5000 }, { 0, 5000 } };
+        setitimer(ITIMER_PROF, &period, nullptr);
+    }
+
+    std::vector<long long> latencies{};
+    report(name, numberOfThreads, 2 * operationsPerThread * numberOfThreads, benchmarkQueue(queue, numberOfThreads, latencies));
+    reportLatencies(latencies);
+
+    if (stalled) {
+        itimerval stop{};
+        setitimer(ITIMER_PROF, &stop, nullptr);
+        std::signal(SIGPROF, SIG_DFL);
+    }
+}
+
+int main() {
+    for (bool stalled : { false, true }) {
+
+        std::cout << (stalled ? "Stalled threads" : "Oversubscribed threads") << std::endl;
+
+        for (size_t numberOfThreads : { 2, 8, 32 }) {
+
+            auto ring = std::make_unique<LockFreeQueue<unsigned long long, 1024>>(numberOfThreads);
+            run("LockFreeQueue", *ring, numberOfThreads, stalled);
+
+            auto lockFree = std::make_unique<MichaelScottQueue<unsigned long long>>(numberOfThreads + 1);
+            run("MichaelScottQueue (lock-free)", *lockFree, numberOfThreads, stalled);
+
+            auto waitFree = std::make_unique<WaitFreeQueue<unsigned long long>>(numberOfThreads + 1);
+            run("WaitFreeQueue", *waitFree, numberOfThreads, stalled);
+        }
+    }
+
+    return 0;
+}
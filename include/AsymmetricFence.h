@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+
+#if defined(__linux__) && __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LOCKFREEQUEUE_HAS_MEMBARRIER 1
+#endif
+
+/** Check if the heavy fence can make every thread of the process issue a barrier.
+ *
+ *  The process registers for expedited private membarrier on the first
+ *  call. Without membarrier (off Linux, on kernels older than 4.14, or
+ *  when a seccomp filter denies it) both fences are full fences.
+ *
+ *  @return true if the light fence may be a compiler barrier only.
+ */
+inline bool asymmetricFencesSupported() {
+
+#if defined(LOCKFREEQUEUE_HAS_MEMBARRIER)
+    static const bool supported{ syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0 };
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/** The cheap side of a pair of sequentially consistent fences.
+ *
+ *  The purpose of the "asymmetricFenceLight" function is to order a store
+ *  before a load on a hot path, when the thread on the other side of the
+ *  race is rare and can pay for the whole barrier in asymmetricFenceHeavy.
+ */
+inline void asymmetricFenceLight() {
+
+    if (asymmetricFencesSupported()) {
+        std::atomic_signal_fence(std::memory_order_seq_cst); // The heavy fence interrupts us if needed.
+    }
+    else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+/** The expensive side of a pair of sequentially consistent fences.
+ *
+ *  Pairs with the asymmetricFenceLight of every other thread of the
+ *  process as if both were sequentially consistent fences. This costs a
+ *  system call, a few microseconds.
+ */
+inline void asymmetricFenceHeavy() {
+
+#if defined(LOCKFREEQUEUE_HAS_MEMBARRIER)
+    if (asymmetricFencesSupported()) {
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include <Sequence.h>
+
+/** A single-producer/multi-consumer ring where every consumer sees every item.
+ *
+ *  The purpose of the "BroadcastRing" is to fan data out to several
+ *  independent consumers while writing it only once. Each consumer owns a
+ *  read cursor and the producer only reuses a space once the slowest
+ *  consumer has read it.
+ *
+ *  The number of consumers is fixed on construction. Consumer i must only
+ *  be served by one thread at a time, and only one thread may push.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class BroadcastRing {
+public:
+
+    using ItemType = QueueItemT;
+
+    BroadcastRing() = delete;
+
+    /** A constructor which takes the number of consumers as argument.
+     *
+     *  @arg numberOfConsumers - the number of consumers, identified as 0 to numberOfConsumers-1.
+     */
+    explicit BroadcastRing(size_t numberOfConsumers)
+    : _numberOfConsumers{ numberOfConsumers },
+      _cursors{ std::make_unique<ConsumerCursor[]>(numberOfConsumers) }
+    {}
+
+    ~BroadcastRing() = default;
+
+    // Make the ring non copyable.
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    /** Push data into the ring.
+     *
+     *  If the slowest consumer has not read the space the data would go
+     *  into, the thread will return false and will not wait for it.
+     *
+     *  @arg bufferItem - the data to be pushed into the ring.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        if (_next - _gatingCache >= bufferSize) { // Only look at the consumers when the cached position says we are full.
+
+            _gatingCache = slowestCursor();
+
+            if (_next - _gatingCache >= bufferSize) {
+                return false; // The slowest consumer has not caught up yet.
+            }
+        }
+
+        _buffer[_next % bufferSize] = std::move(bufferItem);
+
+        ++_next;
+        _published.value.store(_next, std::memory_order_release); // Make the data visible to the consumers.
+
+        return true;
+    }
+
+    /** Pop the next data of a consumer.
+     *
+     *  The data stays in the ring until every consumer has read it.
+     *
+     *  @arg consumer - the consumer reading the data.
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available for the consumer, false otherwise.
+     */
+    bool pop(size_t consumer, QueueItemT& popedData) {
+
+        ConsumerCursor& cursor = _cursors[consumer];
+        size_t position = cursor.position.load(std::memory_order_relaxed);
+
+        if (position == cursor.publishedCache) { // Only look at the producer when the cached position says we are empty.
+
+            cursor.publishedCache = _published.value.load(std::memory_order_acquire);
+
+            if (position == cursor.publishedCache) {
+                return false;
+            }
+        }
+
+        popedData = _buffer[position % bufferSize];
+
+        cursor.position.store(position + 1, std::memory_order_release); // Let the producer reuse the space.
+
+        return true;
+    }
+
+    /** Check if there is data a consumer has not read yet.
+     *
+     *  @arg consumer - the consumer to check for.
+     *
+     *  @return true if there is data for the consumer, false otherwise.
+     */
+    bool hasData(size_t consumer) {
+        return _cursors[consumer].position.load(std::memory_order_relaxed) !=
+               _published.value.load(std::memory_order_acquire);
+    }
+
+private:
+    struct alignas(cacheLineSize) ConsumerCursor {
+        std::atomic<size_t> position{ 0 }; // the next sequence the consumer reads
+        size_t publishedCache{ 0 }; // the last published sequence the consumer saw
+    };
+
+    /** Find the position of the slowest consumer.
+     *
+     *  @return the smallest consumer position.
+     */
+    size_t slowestCursor() {
+        size_t slowest{ _next };
+        for (size_t i = 0; i < _numberOfConsumers; ++i) {
+            size_t position = _cursors[i].position.load(std::memory_order_acquire);
+            if (position < slowest) {
+                slowest = position;
+            }
+        }
+        return slowest;
+    }
+
+    std::array<QueueItemT, bufferSize> _buffer{}; // the ring buffer
+    Sequence _published{}; // the number of items published by the producer
+
+    alignas(cacheLineSize) size_t _next{ 0 }; // the next sequence the producer writes (producer only)
+    size_t _gatingCache{ 0 }; // the last slowest consumer position the producer saw (producer only)
+    size_t _numberOfConsumers{ 0 };
+    std::unique_ptr<ConsumerCursor[]> _cursors; // the consumer positions
+};
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include <ScqQueue.h>
+#include <Sequence.h>
+
+/** A multi-producer/multi-consumer queue which only keeps the last value of each key.
+ *
+ *  The purpose of the "ConflatingQueue" is to spare the consumers of an
+ *  update feed (eg. prices per instrument) the stale updates: a push for a
+ *  key which is still waiting in the queue replaces its value in place, so
+ *  a burst of updates costs one pop per key instead of one per update.
+ *
+ *  Every key owns an entry, found through an open addressing table, and
+ *  the ready ring (an ScqRing) holds the entries which have a value
+ *  waiting, in the order they first got one. An entry is in the ready ring
+ *  at most once, so the ring never fills up. The value of an entry is
+ *  guarded by a spin lock in the _canUpdate style of MpmcQueue, held only
+ *  for the copy of one value.
+ *
+ *  A key keeps its entry once it was pushed, so the queue is bounded by the
+ *  number of distinct keys: once maxKeys keys were seen, a push for a new
+ *  key fails while the known keys keep working. maxKeys must be a power of two.
+ */
+template<typename KeyT, typename ValueT, size_t maxKeys, typename HashT = std::hash<KeyT>>
+class ConflatingQueue {
+
+    static constexpr size_t tableSize{ 2 * maxKeys }; // the number of buckets, at most half of them used
+    static constexpr size_t noIndex{ ScqRing<maxKeys>::noIndex };
+    static constexpr size_t spinsBeforeYield{ 64 };
+
+    struct Bucket {
+        std::atomic<size_t> index{ noIndex }; // the entry of the key hashed here, set once
+        std::atomic_bool canUpdate{ true }; // guards the claim of the bucket
+    };
+
+    struct alignas(cacheLineSize) Entry {
+        std::atomic_bool canUpdate{ true }; // guards the value and the pending flag
+        bool pending{ false }; // true while the entry is in the ready ring
+        KeyT key{}; // written once, before the entry is published in its bucket
+        ValueT value{};
+    };
+
+public:
+
+    using ItemType = std::pair<KeyT, ValueT>;
+
+    ConflatingQueue() = default;
+    ~ConflatingQueue() = default;
+
+    // Make the queue non copyable.
+    ConflatingQueue(const ConflatingQueue&) = delete;
+    ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+
+    /** Push the value of a key, replacing its previous value if it was not poped yet.
+     *
+     *  If the key is new and maxKeys keys were already seen, or the queue
+     *  is closed, the thread will return false.
+     *
+     *  @arg key - the key the value belongs to.
+     *  @arg value - the value to be pushed into the queue.
+     */
+    bool push(KeyT key, ValueT value) {
+
+        if (_closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        size_t index = findEntry(key);
+
+        if (index == noIndex) {
+            return false; // No room for a new key.
+        }
+
+        Entry& entry = _entries[index];
+
+        lock(entry.canUpdate);
+
+        bool replaced = entry.pending;
+        entry.value = std::move(value);
+        entry.pending = true;
+
+        entry.canUpdate.store(true, std::memory_order_release);
+
+        if (replaced) {
+            _conflated.value.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            _ready.enqueue(index); // Publish the entry, the pop will take the latest value.
+        }
+
+        return true;
+    }
+
+    /** Push a key and its value.
+     *
+     *  @arg bufferItem - the key and the value to be pushed into the queue.
+     */
+    bool push(ItemType bufferItem) {
+        return push(std::move(bufferItem.first), std::move(bufferItem.second));
+    }
+
+    /** Pop the latest value of the key which has waited the longest.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the key and its value into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(ItemType& popedData) {
+
+        size_t index = _ready.dequeue();
+
+        if (index == noIndex) {
+            return false;
+        }
+
+        Entry& entry = _entries[index];
+
+        lock(entry.canUpdate);
+
+        popedData.first = entry.key;
+        popedData.second = std::move(entry.value);
+        entry.pending = false;
+
+        entry.canUpdate.store(true, std::memory_order_release);
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _ready.hasIndexes();
+    }
+
+    /** Check if there is space for a new key.
+     *
+     *  The keys already seen always have space.
+     *
+     * @return true if a new key can be pushed, false otherwise.
+     */
+    bool hasSpace() {
+        return _numberOfKeys.value.load(std::memory_order_relaxed) < maxKeys;
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push which starts fails, while a push which
+     *  already passed its check may still land. The data in the queue can
+     *  still be poped.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+    /** Get the number of values replaced before they were poped.
+     *
+     * @return the number of conflated pushes.
+     */
+    size_t conflated() {
+        return _conflated.value.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    /** Find the entry of a key, giving it one if it is new.
+     *
+     *  @arg key - the key to look for.
+     *
+     *  @return the index of the entry, or noIndex if the key is new and there is no entry left.
+     */
+    size_t findEntry(const KeyT& key) {
+
+        size_t hash = HashT{}(key);
+
+        for (size_t probe = 0; probe < tableSize; ++probe) {
+
+            Bucket& bucket = _buckets[(hash + probe) % tableSize];
+            size_t index = bucket.index.load(std::memory_order_acquire);
+
+            if (index == noIndex) { // Claim the bucket, unless another thread is claiming it.
+
+                lock(bucket.canUpdate);
+
+                index = bucket.index.load(std::memory_order_relaxed);
+                if (index == noIndex) {
+                    index = takeEntry();
+                    if (index != noIndex) {
+                        _entries[index].key = key;
+                        bucket.index.store(index, std::memory_order_release);
+                    }
+                }
+
+                bucket.canUpdate.store(true, std::memory_order_release);
+
+                if (index == noIndex) {
+                    return noIndex;
+                }
+            }
+
+            if (_entries[index].key == key) {
+                return index;
+            }
+        }
+
+        return noIndex;
+    }
+
+    /** Take an unused entry.
+     *
+     *  @return the index of the entry, or noIndex if every entry has a key.
+     */
+    size_t takeEntry() {
+
+        size_t count = _numberOfKeys.value.load(std::memory_order_relaxed);
+
+        do {
+            if (count == maxKeys) {
+                return noIndex;
+            }
+        } while (!_numberOfKeys.value.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+
+        return count;
+    }
+
+    static void lock(std::atomic_bool& canUpdate) {
+
+        size_t spins{ 0 };
+
+        while (!canUpdate.exchange(false, std::memory_order_acquire)) {
+            if (++spins >= spinsBeforeYield) { // The holder may have been preempted, give it the CPU.
+                std::this_thread::yield();
+                spins = 0;
+            }
+        }
+    }
+
+    ScqRing<maxKeys> _ready{ false }; // the entries with a value waiting
+    Sequence _numberOfKeys{}; // the number of entries given to a key
+    Sequence _conflated{}; // the number of replaced values
+    std::atomic_bool _closed{ false }; // set once the queue is closed
+    std::array<Bucket, tableSize> _buckets{}; // key hash to entry index
+    std::array<Entry, maxKeys> _entries{}; // one per key
+};
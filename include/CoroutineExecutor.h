@@ -0,0 +1,134 @@
+#pragma once
+
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+/** A minimal executor for coroutines.
+ *
+ *  The purpose of the "CoroutineExecutor" is to resume suspended coroutines
+ *  on whichever threads call "run". Any number of threads may call "run"
+ *  concurrently, which lets thousands of logical consumers/producers share
+ *  a handful of threads.
+ *
+ *  It is intentionally simple (a mutex protected deque) since it is only
+ *  touched when a coroutine suspends or is resumed, never on the fast path
+ *  of the queue.
+ */
+class CoroutineExecutor {
+public:
+
+    CoroutineExecutor() = default;
+    ~CoroutineExecutor() = default;
+
+    // Make the executor non copyable.
+    CoroutineExecutor(const CoroutineExecutor&) = delete;
+    CoroutineExecutor& operator=(const CoroutineExecutor&) = delete;
+
+    /** Schedule a coroutine to be resumed by one of the "run" threads.
+     *
+     *  @arg handle - the suspended coroutine to resume.
+     */
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            _ready.push_back(handle);
+        }
+        _cv.notify_one();
+    }
+
+    /** Resume scheduled coroutines until "stop" is called.
+     *
+     *  Coroutines still scheduled when the executor is stopped are not resumed.
+     */
+    void run() {
+        while (true) {
+            std::coroutine_handle<> handle{};
+            {
+                std::unique_lock<std::mutex> locker(_mu);
+                _cv.wait(locker, [this]() { return _stopped || !_ready.empty(); });
+
+                if (_stopped) {
+                    return;
+                }
+
+                handle = _ready.front();
+                _ready.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    /** Resume at most one scheduled coroutine on the calling thread.
+     *
+     *  @return true if a coroutine was resumed, false otherwise.
+     */
+    bool runOne() {
+        std::coroutine_handle<> handle{};
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            if (_ready.empty()) {
+                return false;
+            }
+            handle = _ready.front();
+            _ready.pop_front();
+        }
+        handle.resume();
+        return true;
+    }
+
+    /** Make every thread blocked in "run" return.
+     */
+    void stop() {
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            _stopped = true;
+        }
+        _cv.notify_all();
+    }
+
+    /** An awaitable which moves the awaiting coroutine onto the executor.
+     */
+    class ScheduleAwaiter {
+    public:
+        explicit ScheduleAwaiter(CoroutineExecutor& executor) : _executor{ executor }
+        {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { _executor.post(handle); }
+        void await_resume() const noexcept {}
+
+    private:
+        CoroutineExecutor& _executor;
+    };
+
+    /** Continue the awaiting coroutine on one of the "run" threads.
+     *
+     *  eg. co_await executor.schedule();
+     */
+    ScheduleAwaiter schedule() {
+        return ScheduleAwaiter{ *this };
+    }
+
+private:
+    std::mutex _mu;
+    std::condition_variable _cv;
+    std::deque<std::coroutine_handle<>> _ready{}; // the coroutines waiting to be resumed
+    bool _stopped{ false };
+};
+
+/** A fire-and-forget coroutine return type.
+ *
+ *  The coroutine starts eagerly and its frame is destroyed when it finishes.
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <Sequence.h>
+
+/** Epoch-based memory reclamation, with optional hazard pointers.
+ *
+ *  The purpose of the "EpochReclamation" domain is to let node-based or
+ *  growable structures free memory which other threads might still be
+ *  reading, without locks. A thread reads shared nodes inside a pinned
+ *  section, and a node which has been unlinked is retired instead of
+ *  deleted. A retired node is only freed once every thread has left the
+ *  pinned sections that might have seen it: the global epoch advances when
+ *  every pinned thread has observed it, and a node retired in epoch e is
+ *  freed once the global epoch reaches e + 2.
+ *
+ *  A thread which has to keep a few nodes for a long time (eg. while
+ *  blocking) can protect them with hazard pointers instead of staying
+ *  pinned, so it does not hold back the epoch and the garbage of every
+ *  other thread. A node is freed only if it is both epoch safe and not
+ *  protected by any hazard pointer.
+ *
+ *  Every thread joins the domain to get a Participant. Retired nodes are
+ *  kept in the participant's own list and freed in batches, every
+ *  batchSize retirements. As long as no thread stays pinned forever, each
+ *  participant holds at most the nodes it retired during the last two
+ *  epochs plus one batch.
+ *
+ *  eg. auto participant = domain.join();
+ *      {
+ *          auto guard = participant.pin();
+ *          Node* node = head.load(std::memory_order_acquire); // safe to read until the guard goes
+ *          ...
+ *      }
+ *      participant.retire(unlinkedNode);
+ *
+ *  @arg hazardPointers - the number of hazard pointers of each participant, 0 to only use epochs.
+ */
+template<size_t hazardPointers = 0>
+class EpochReclamation {
+
+    struct ThreadRecord;
+
+public:
+
+    EpochReclamation() = delete;
+
+    /** A constructor which takes the maximum number of participants as argument.
+     *
+     *  @arg maxThreads - the maximum number of threads joined at the same time.
+     *  @arg batchSize - the number of retirements between two attempts to free memory.
+     */
+    explicit EpochReclamation(size_t maxThreads, size_t batchSize = 64)
+    : _maxThreads{ maxThreads },
+      _batchSize{ batchSize == 0 ? 1 : batchSize },
+      _records{ std::make_unique<ThreadRecord[]>(maxThreads) }
+    {}
+
+    /** Free every retired node.
+     *
+     *  Every participant must have left the domain.
+     */
+    ~EpochReclamation() {
+        for (Orphan* orphan = _orphans.exchange(nullptr, std::memory_order_acquire); orphan != nullptr; ) {
+            for (Retired& retired : orphan->retired) {
+                retired.deleter(retired.pointer);
+            }
+            Orphan* next = orphan->next;
+            delete orphan;
+            orphan = next;
+        }
+    }
+
+    // Make the domain non copyable.
+    EpochReclamation(const EpochReclamation&) = delete;
+    EpochReclamation& operator=(const EpochReclamation&) = delete;
+
+    class Participant;
+
+    /** Keeps the calling thread pinned for as long as it lives.
+     */
+    class Guard {
+    public:
+        explicit Guard(Participant& participant) : _participant{ participant } {
+            _participant.enter();
+        }
+
+        ~Guard() {
+            _participant.leave();
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        Participant& _participant;
+    };
+
+    /** The membership of one thread in the domain.
+     *
+     *  A participant must only be used by the thread which joined. When it
+     *  leaves, the nodes it could not free yet are handed to the domain and
+     *  freed by the other participants.
+     */
+    class Participant {
+    public:
+        Participant(EpochReclamation& domain, ThreadRecord& record) : _domain{ domain }, _record{ record } {}
+
+        ~Participant() {
+
+            for (size_t slot = 0; slot < hazardPointers; ++slot) {
+                clear(slot);
+            }
+
+            _record.epoch.store(0, std::memory_order_release);
+
+            reclaim();
+
+            if (!_record.retired.empty()) {
+                _domain.adopt(std::move(_record.retired)); // Let the other participants free the rest.
+                _record.retired.clear();
+            }
+
+            _record.inUse.store(false, std::memory_order_release);
+        }
+
+        Participant(const Participant&) = delete;
+        Participant& operator=(const Participant&) = delete;
+
+        /** Pin the thread until the returned guard is destroyed.
+         *
+         *  Guards can be nested.
+         */
+        Guard pin() {
+            return Guard{ *this };
+        }
+
+        /** The index of the participant, below maxThreads and unique among the participants joined at the same time.
+         */
+        size_t index() const {
+            return static_cast<size_t>(&_record - _domain._records.get());
+        }
+
+        /** Retire a node which can no longer be reached from the shared structure.
+         *
+         *  @arg pointer - the node, freed with delete once no thread can be reading it.
+         */
+        template<typename T>
+        void retire(T* pointer) {
+            retire(pointer, [](void* node) { delete static_cast<T*>(node); });
+        }
+
+        /** Retire memory which can no longer be reached from the shared structure.
+         *
+         *  @arg pointer - the memory to free.
+         *  @arg deleter - frees the memory once no thread can be reading it.
+         */
+        void retire(void* pointer, void (*deleter)(void*)) {
+
+            std::atomic_thread_fence(std::memory_order_seq_cst); // Order the unlinking before reading the epoch.
+
+            _record.retired.push_back(Retired{ pointer, deleter, _domain._epoch.value.load(std::memory_order_relaxed) });
+
+            if (++_record.retiredSinceReclaim >= _domain._batchSize) {
+                reclaim();
+            }
+        }
+
+        /** Try to advance the epoch and free the retired nodes which became safe.
+         *
+         *  @return the number of nodes freed.
+         */
+        size_t reclaim() {
+
+            _record.retiredSinceReclaim = 0;
+
+            _domain.tryAdvance();
+
+            Orphan* orphans = _domain.takeOrphans();
+            bool adopted{ orphans != nullptr };
+
+            while (orphans != nullptr) { // Adopt the garbage of the participants which left.
+                _record.retired.insert(_record.retired.end(), orphans->retired.begin(), orphans->retired.end());
+                Orphan* next = orphans->next;
+                delete orphans;
+                orphans = next;
+            }
+
+            if (adopted) {
+                std::stable_sort(_record.retired.begin(), _record.retired.end(),
+                                 [](const Retired& first, const Retired& second) { return first.epoch < second.epoch; });
+            }
+
+            uint64_t safeEpoch = _domain._epoch.value.load(std::memory_order_acquire);
+
+            if (safeEpoch == _record.reclaimedEpoch && !adopted && hazardPointers == 0) {
+                return 0; // Nothing became safe since the last time.
+            }
+
+            _record.reclaimedEpoch = safeEpoch;
+
+            std::vector<void*> hazards{};
+            if constexpr (hazardPointers != 0) {
+                std::atomic_thread_fence(std::memory_order_seq_cst); // Order the unlinking before reading the hazard pointers.
+                hazards = _domain.protectedPointers();
+            }
+
+            size_t freed{ 0 };
+            size_t kept{ 0 };
+            size_t scanned{ 0 };
+
+            for (; scanned < _record.retired.size() && _record.retired[scanned].epoch + 2 <= safeEpoch; ++scanned) { // The list is 
+                                                                                                                      // sorted by epoch.
+                Retired& retired = _record.retired[scanned];
+
+                if (std::binary_search(hazards.begin(), hazards.end(), retired.pointer)) {
+                    _record.retired[kept++] = retired; // Still protected, keep it for a later reclaim.
+                    continue;
+                }
+
+                retired.deleter(retired.pointer);
+                ++freed;
+            }
+
+            _record.retired.erase(_record.retired.begin() + kept, _record.retired.begin() + scanned);
+
+            return freed;
+        }
+
+        /** Protect a node with a hazard pointer, without pinning the thread.
+         *
+         *  The node stays safe to read until the slot is cleared or reused.
+         *
+         *  @arg slot - the hazard pointer to use, from 0 to hazardPointers-1.
+         *  @arg source - the shared pointer to the node.
+         *
+         *  @return the protected node, as read from source.
+         */
+        template<typename T>
+        T* protect(size_t slot, const std::atomic<T*>& source) requires (hazardPointers != 0) {
+
+            T* pointer = source.load(std::memory_order_acquire);
+
+            while (true) {
+
+                _record.hazards[slot].store(pointer, std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst); // Publish the hazard before checking it is still linked.
+
+                T* current = source.load(std::memory_order_acquire);
+                if (current == pointer) {
+                    return pointer;
+                }
+
+                pointer = current; // It was unlinked meanwhile and might already be retired, try again.
+            }
+        }
+
+        /** Stop protecting the node of a hazard pointer.
+         *
+         *  @arg slot - the hazard pointer to clear.
+         */
+        void clear(size_t slot) {
+            if constexpr (hazardPointers != 0) {
+                _record.hazards[slot].store(nullptr, std::memory_order_release);
+            }
+        }
+
+        /** The number of retired nodes not freed yet.
+         */
+        size_t pending() const {
+            return _record.retired.size();
+        }
+
+    private:
+        friend class Guard;
+
+        /** Pin the thread, or go one level deeper if it already is.
+         */
+        void enter() {
+
+            if (_record.pinDepth++ != 0) {
+                return;
+            }
+
+            uint64_t epoch = _domain._epoch.value.load(std::memory_order_relaxed);
+
+            _record.epoch.store((epoch << 1) | 1, std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst); // Announce the pin before reading any node.
+        }
+
+        /** Unpin the thread once the outermost guard goes.
+         */
+        void leave() {
+            if (--_record.pinDepth == 0) {
+                _record.epoch.store(0, std::memory_order_release); // Done reading nodes.
+            }
+        }
+
+        EpochReclamation& _domain;
+        ThreadRecord& _record;
+    };
+
+    /** Join the domain from the calling thread.
+     *
+     *  @return the membership of the thread, to keep for as long as it uses the domain.
+     */
+    Participant join() {
+
+        for (size_t i = 0; i < _maxThreads; ++i) {
+            if (!_records[i].inUse.load(std::memory_order_relaxed) &&
+                !_records[i].inUse.exchange(true, std::memory_order_acquire)) {
+                return Participant{ *this, _records[i] };
+            }
+        }
+
+        throw std::length_error("EpochReclamation: more than maxThreads participants");
+    }
+
+    /** The current global epoch.
+     */
+    uint64_t epoch() const {
+        return _epoch.value.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Retired {
+        void* pointer; // the memory to free
+        void (*deleter)(void*); // frees the memory
+        uint64_t epoch; // the global epoch when it was retired
+    };
+
+    struct alignas(cacheLineSize) ThreadRecord {
+        std::atomic<uint64_t> epoch{ 0 }; // (epoch << 1) | 1 while pinned, 0 otherwise
+        std::atomic_bool inUse{ false }; // true while a participant owns the record
+        std::array<std::atomic<void*>, hazardPointers> hazards{}; // the nodes protected by the participant
+        size_t pinDepth{ 0 }; // the number of live guards (owner only)
+        size_t retiredSinceReclaim{ 0 }; // the retirements since the last reclaim (owner only)
+        uint64_t reclaimedEpoch{ 0 }; // the global epoch of the last reclaim (owner only)
+        std::vector<Retired> retired{}; // the nodes retired and not freed yet (owner only)
+    };
+
+    struct Orphan {
+        std::vector<Retired> retired; // the nodes a participant left behind
+        Orphan* next{ nullptr };
+    };
+
+    /** Advance the global epoch if every pinned thread has observed it.
+     */
+    void tryAdvance() {
+
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Order our retirements before reading the pins.
+
+        uint64_t epoch = _epoch.value.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < _maxThreads; ++i) {
+            uint64_t pinned = _records[i].epoch.load(std::memory_order_acquire);
+            if ((pinned & 1) != 0 && (pinned >> 1) != epoch) {
+                return; // A thread is still reading in an older epoch.
+            }
+        }
+
+        _epoch.value.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+
+    /** Collect the nodes protected by the hazard pointers of every participant.
+     *
+     *  @return the protected nodes, sorted.
+     */
+    std::vector<void*> protectedPointers() {
+
+        std::vector<void*> hazards{};
+
+        for (size_t i = 0; i < _maxThreads; ++i) {
+            for (auto& hazard : _records[i].hazards) {
+                void* pointer = hazard.load(std::memory_order_acquire);
+                if (pointer != nullptr) {
+                    hazards.push_back(pointer);
+                }
+            }
+        }
+
+        std::sort(hazards.begin(), hazards.end());
+
+        return hazards;
+    }
+
+    /** Hand the garbage of a leaving participant to the domain.
+     *
+     *  @arg retired - the nodes the participant could not free.
+     */
+    void adopt(std::vector<Retired> retired) {
+
+        Orphan* orphan = new Orphan{ std::move(retired) };
+
+        orphan->next = _orphans.load(std::memory_order_relaxed);
+        while (!_orphans.compare_exchange_weak(orphan->next, orphan,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+    }
+
+    /** Take all the garbage left by the participants which left.
+     *
+     *  Orphans are only ever added one by one or taken all at once, which avoids the ABA problem.
+     *
+     *  @return the first orphan of the chain, or nullptr if there is none.
+     */
+    Orphan* takeOrphans() {
+        return _orphans.load(std::memory_order_relaxed) == nullptr ?
+                    nullptr :
+                    _orphans.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    Sequence _epoch{}; // the global epoch
+    size_t _maxThreads{ 0 };
+    size_t _batchSize{ 0 };
+    std::unique_ptr<ThreadRecord[]> _records; // one record per joined thread
+    std::atomic<Orphan*> _orphans{ nullptr }; // the garbage of the participants which left
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <QueueNotifier.h>
+
+/** A notifier which signals an eventfd, so a queue can be watched by an epoll loop.
+ *
+ *  The purpose of the "EventFdNotifier" is to let a thread which can not
+ *  block in a queue (eg. a network thread running an epoll loop) learn that
+ *  data was pushed. The eventfd is only written on the empty to non-empty
+ *  transition, so a burst of pushes costs a single system call.
+ *
+ *  The eventfd is meant to be registered level-triggered (the default):
+ *  "drain" leaves it readable for as long as there might be data left.
+ *
+ *  eg. queue.setNotifier(&notifier);
+ *      epoll_ctl(epollFd, EPOLL_CTL_ADD, notifier.nativeHandle(), &event);
+ *      ...
+ *      notifier.drain(queue, handler, 64); // when the eventfd is readable
+ *
+ *  Only one thread must drain the queues attached to a notifier.
+ */
+class EventFdNotifier : public QueueNotifier {
+public:
+
+    EventFdNotifier()
+    : _fd{ eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) } {
+        if (_fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "eventfd");
+        }
+    }
+
+    ~EventFdNotifier() override {
+        ::close(_fd);
+    }
+
+    // Make the notifier non copyable.
+    EventFdNotifier(const EventFdNotifier&) = delete;
+    EventFdNotifier& operator=(const EventFdNotifier&) = delete;
+
+    /** Signal the eventfd, unless it has already been signaled since the last drain.
+     */
+    void notify() override {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Order the pushed data before reading the flag.
+
+        if (_armed.load(std::memory_order_relaxed) &&
+            _armed.exchange(false, std::memory_order_acq_rel)) { // Only the first push of a burst signals.
+            signal();
+        }
+    }
+
+    /** Get the eventfd to register with an event loop.
+     *
+     *  @return the eventfd file descriptor.
+     */
+    int nativeHandle() const {
+        return _fd;
+    }
+
+    /** Get the number of times the eventfd was written.
+     *
+     *  @return the number of eventfd writes so far.
+     */
+    uint64_t signalCount() const {
+        return _signalCount.load(std::memory_order_relaxed);
+    }
+
+    /** Pop and handle up to maxBatch items.
+     *
+     *  The purpose of the "drain" function is to consume a burst of data
+     *  once the eventfd is readable. When the queue is found empty the
+     *  eventfd is cleared and the notifier re-armed. When the batch limit
+     *  is reached first, the eventfd is left readable so the event loop
+     *  comes back for the rest.
+     *
+     *  A push which is still being copied makes the queue report data that
+     *  can not be poped yet. Then the eventfd is left cleared and armed, so
+     *  the drain returns instead of spinning, and the notify that ends the
+     *  push signals the eventfd again.
+     *
+     *  @arg queue - the queue to pop from.
+     *  @arg handler - called with every poped item.
+     *  @arg maxBatch - the maximum number of items to pop.
+     *
+     *  @return the number of items handled.
+     */
+    template<typename QueueT, typename HandlerT>
+    size_t drain(QueueT& queue, HandlerT&& handler, size_t maxBatch) {
+
+        typename QueueT::ItemType popedData{};
+        size_t handled{ 0 };
+        bool cleared{ false }; // true if we cleared the eventfd and took the signal back ourselves
+        bool retook{ false }; // true if the signal was taken back since the last pop
+
+        while (handled < maxBatch) {
+
+            if (queue.pop(popedData)) {
+                handler(popedData);
+                ++handled;
+                retook = false;
+                continue;
+            }
+
+            if (!_armed.load(std::memory_order_relaxed)) {
+
+                clear();
+                _armed.store(true, std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst); // Order re-arming before checking for data.
+
+                if (!retook && queue.hasData() && _armed.exchange(false, std::memory_order_acq_rel)) {
+                    cleared = true; // Data was pushed while re-arming and no producer signaled it.
+                    retook = true;
+                    continue;
+                }
+            }
+
+            return handled; // The queue is empty and the notifier armed.
+        }
+
+        if (cleared && queue.hasData()) {
+            signal(); // We stopped early, make sure the event loop comes back.
+        }
+        else if (queue.hasData() && _armed.load(std::memory_order_relaxed) &&
+                 _armed.exchange(false, std::memory_order_acq_rel)) {
+            signal(); // We were called without a pending signal and left data behind.
+        }
+
+        return handled;
+    }
+
+private:
+    /** Make the eventfd readable.
+     */
+    void signal() {
+        uint64_t value{ 1 };
+        while (::write(_fd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+        _signalCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Make the eventfd non readable.
+     */
+    void clear() {
+        uint64_t value{};
+        while (::read(_fd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+    }
+
+    int _fd{ -1 }; // the eventfd
+    std::atomic_bool _armed{ true }; // true if the next push must signal the eventfd
+    std::atomic<uint64_t> _signalCount{ 0 }; // count the eventfd writes
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <Sequence.h>
+
+/** A multi-producer/multi-consumer queue run by flat combining.
+ *
+ *  The purpose of the "FlatCombiningQueue" is to serve workloads where many
+ *  threads push and pop small items and most of their time would be spent
+ *  fighting over the indexes. Instead of entering the queue, a thread
+ *  publishes its request in a slot of its own. Whichever thread takes the
+ *  combiner lock then serves every published request against a plain
+ *  sequential ring, so the ring and its indexes stay in one core's cache and
+ *  the other threads only spin on their own slot.
+ *
+ *  A thread holds a slot for the duration of one operation. With more
+ *  concurrent threads than slots, the extra ones wait for a slot to free up.
+ *  Every space of the ring can be used.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class FlatCombiningQueue {
+
+    enum class Request : uint8_t {
+        None, // nothing published
+        Push, // the slot's item is to be pushed
+        Pop,  // an item is to be poped into the slot
+        Done  // served, the result is in the slot
+    };
+
+    struct alignas(cacheLineSize) Slot {
+        std::atomic_bool taken{ false }; // held by a thread for one operation
+        std::atomic<Request> request{ Request::None };
+        bool succeeded{ false }; // the result, written by the combiner before Done
+        QueueItemT item{};
+    };
+
+    static constexpr size_t spinsBeforeYield{ 64 };
+    static constexpr size_t combiningPasses{ 3 }; // how many times the combiner rescans for new requests
+
+public:
+
+    using ItemType = QueueItemT;
+
+    /** A constructor which takes the number of publication slots as argument.
+     *
+     *  @arg numberOfSlots - the number of threads which can publish at the same time, at least one.
+     */
+    explicit FlatCombiningQueue(size_t numberOfSlots = 64)
+    : _numberOfSlots{ numberOfSlots == 0 ? 1 : numberOfSlots },
+      _slots{ std::make_unique<Slot[]>(_numberOfSlots) }
+    {}
+
+    ~FlatCombiningQueue() = default;
+
+    // Make the queue non copyable.
+    FlatCombiningQueue(const FlatCombiningQueue&) = delete;
+    FlatCombiningQueue& operator=(const FlatCombiningQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        Slot& slot = takeSlot();
+
+        slot.item = std::move(bufferItem);
+        bool succeeded = serve(slot, Request::Push);
+
+        releaseSlot(slot);
+
+        return succeeded;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        if (!hasData()) {
+            return false; // Do not queue up behind the combiner for nothing.
+        }
+
+        Slot& slot = takeSlot();
+
+        bool succeeded = serve(slot, Request::Pop);
+        if (succeeded) {
+            popedData = std::move(slot.item);
+        }
+
+        releaseSlot(slot);
+
+        return succeeded;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _tail.load(std::memory_order_acquire) != _head.load(std::memory_order_acquire);
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true if there is space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire) < bufferSize;
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped.
+     */
+    void close() {
+        lock();
+        _closed.store(true, std::memory_order_relaxed);
+        _combining.store(false, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+private:
+
+    /** Publish a request and wait until a combiner, possibly this thread, served it.
+     *
+     *  @arg slot - the slot of the thread.
+     *  @arg request - what to do.
+     *
+     *  @return true if the request succeeded, false otherwise.
+     */
+    bool serve(Slot& slot, Request request) {
+
+        slot.request.store(request, std::memory_order_release);
+
+        size_t spins{ 0 };
+
+        while (slot.request.load(std::memory_order_acquire) != Request::Done) {
+
+            if (!_combining.load(std::memory_order_relaxed) && !_combining.exchange(true, std::memory_order_acquire)) {
+                combine();
+                _combining.store(false, std::memory_order_release);
+                continue;
+            }
+
+            if (++spins >= spinsBeforeYield) { // The combiner may not be running, give it the CPU.
+                std::this_thread::yield();
+                spins = 0;
+            }
+        }
+
+        bool succeeded = slot.succeeded;
+        slot.request.store(Request::None, std::memory_order_relaxed);
+
+        return succeeded;
+    }
+
+    /** Serve every published request against the ring.
+     *
+     *  Must be called with the combiner lock held.
+     */
+    void combine() {
+
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        bool closed = _closed.load(std::memory_order_relaxed);
+
+        for (size_t pass = 0; pass < combiningPasses; ++pass) {
+
+            size_t served{ 0 };
+
+            for (size_t index = 0; index < _numberOfSlots; ++index) {
+
+                Slot& slot = _slots[index];
+                Request request = slot.request.load(std::memory_order_acquire);
+
+                if (request == Request::Push) {
+                    slot.succeeded = !closed && tail - head < bufferSize;
+                    if (slot.succeeded) {
+                        _buffer[tail % bufferSize] = std::move(slot.item);
+                        ++tail;
+                    }
+                }
+                else if (request == Request::Pop) {
+                    slot.succeeded = head != tail;
+                    if (slot.succeeded) {
+                        slot.item = std::move(_buffer[head % bufferSize]);
+                        ++head;
+                    }
+                }
+                else {
+                    continue;
+                }
+
+                slot.request.store(Request::Done, std::memory_order_release);
+                ++served;
+            }
+
+            _head.store(head, std::memory_order_release); // Publish the progress for hasData/hasSpace.
+            _tail.store(tail, std::memory_order_release);
+
+            if (served == 0) {
+                break;
+            }
+        }
+    }
+
+    /** Take the combiner lock, for the operations which are not requests.
+     */
+    void lock() {
+        while (_combining.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /** Find a free slot, starting from the one this thread used last.
+     *
+     *  @return the slot, held by the calling thread.
+     */
+    Slot& takeSlot() {
+
+        thread_local size_t hint{ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+
+        size_t spins{ 0 };
+
+        for (size_t index = hint % _numberOfSlots; ; index = (index + 1) % _numberOfSlots) {
+
+            Slot& slot = _slots[index];
+
+            if (!slot.taken.load(std::memory_order_relaxed) && !slot.taken.exchange(true, std::memory_order_acquire)) {
+                hint = index;
+                return slot;
+            }
+
+            if (++spins >= _numberOfSlots) { // Every slot is taken, let their threads finish.
+                std::this_thread::yield();
+                spins = 0;
+            }
+        }
+    }
+
+    void releaseSlot(Slot& slot) {
+        slot.taken.store(false, std::memory_order_release);
+    }
+
+    alignas(cacheLineSize) std::atomic_bool _combining{ false }; // the combiner lock
+    std::atomic_bool _closed{ false }; // set once the queue is closed
+    alignas(cacheLineSize) std::atomic<size_t> _head{ 0 }; // the next sequence to pop, written by the combiner only
+    std::atomic<size_t> _tail{ 0 }; // the next sequence to push, written by the combiner only
+    size_t _numberOfSlots; // the number of publication slots
+    std::unique_ptr<Slot[]> _slots; // the publication slots
+    std::array<QueueItemT, bufferSize> _buffer{}; // the sequential ring, only touched by the combiner
+};
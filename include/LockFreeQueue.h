@@ -1,20 +1,80 @@
 #pragma once
 
-#include <array>
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <chrono>
 #include <atomic>
 #include <thread>
 #include <optional>
-#include <cmath>
+#include <coroutine>
+#include <type_traits>
+#include <vector>
 
-template<typename QueueItemT, size_t bufferSize>
+#include <AsymmetricFence.h>
+#include <CoroutineExecutor.h>
+#include <MpmcQueue.h>
+#include <MpscQueue.h>
+#include <OverflowPolicy.h>
+#include <QueueNotifier.h>
+#include <QueueStatus.h>
+#include <QueueTopology.h>
+#include <SpmcQueue.h>
+#include <SpscQueue.h>
+#include <WaiterList.h>
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_prefetch)
+#define LOCKFREEQUEUE_HAS_PREFETCH 1
+#endif
+#endif
+
+/** A lock-free queue whose algorithm is picked by its topology.
+ *
+ *  The purpose of the "LockFreeQueue" is to give every topology the same
+ *  API (push/pop, popUntil, close, coroutines and notifiers) on top of the
+ *  cheapest correct algorithm for it, selected at compile time:
+ *
+ *    Producers::Multi,  Consumers::Multi  -> MpmcQueue (the default)
+ *    Producers::Multi,  Consumers::Single -> MpscQueue
+ *    Producers::Single, Consumers::Multi  -> SpmcQueue
+ *    Producers::Single, Consumers::Single -> SpscQueue
+ *
+ *  Waking costs a push or a pop nothing but a relaxed load while nobody
+ *  waits: popUntil, a blocking offer, a suspended coroutine and a notifier
+ *  register as watchers first, and only then is the waking done.
+ *
+ *  The MPMC queue holds bufferSize - 1 items, the others hold bufferSize.
+ *  With a single producer, close must be called by the producer thread or
+ *  once the producer has stopped pushing. Coroutines suspended on a single
+ *  side count as that side: the thread waking them pushes or pops on their
+ *  behalf while they are suspended.
+ */
+template<typename QueueItemT, size_t bufferSize,
+         ProducerPolicy ProducersT = Producers::Multi,
+         ConsumerPolicy ConsumersT = Consumers::Multi>
 class LockFreeQueue {
 
-    using SleepGranularity = std::chrono::nanoseconds;
+    static constexpr bool singleProducer{ std::is_same_v<ProducersT, Producers::Single> };
+    static constexpr bool singleConsumer{ std::is_same_v<ConsumersT, Consumers::Single> };
+
+    using EngineT = std::conditional_t<singleProducer,
+                        std::conditional_t<singleConsumer, SpscQueue<QueueItemT, bufferSize>, SpmcQueue<QueueItemT, bufferSize>>,
+                        std::conditional_t<singleConsumer, MpscQueue<QueueItemT, bufferSize>, MpmcQueue<QueueItemT, bufferSize>>>;
+
+    static_assert(QueueEngine<EngineT>);
+
+    static constexpr size_t capacity{ std::is_same_v<EngineT, MpmcQueue<QueueItemT, bufferSize>> ? bufferSize - 1 : bufferSize };
+
+    template<typename, size_t, ProducerPolicy, ConsumerPolicy>
+    friend class LockFreeQueue; // drainInto works on the engines of both queues.
 
 public:
 
+    using ItemType = QueueItemT;
+    using ProducerType = ProducersT;
+    using ConsumerType = ConsumersT;
+
     LockFreeQueue() = delete;
 
     /** A constructor which takes the total number of consumer+producer threads
@@ -24,14 +84,14 @@ public:
      *  If a custom spin count is provided, the number of threads is ignored and 
      *  the custom spin count is used, as is, instead.
      *
+     *  Only the MPMC queue spins, the other topologies ignore both arguments.
+     *
      *  @arg numberOfThreads - the total number of consumer+producer threads.
      *  @arg customSpinCount - the times a thread will spin before going to sleep.
      */
     LockFreeQueue(std::optional<size_t> numberOfThreads = std::nullopt,
                   std::optional<size_t> customSpinCount = std::nullopt)
-    : sleepDurationStart{numberOfThreads.has_value()?-spinCount(*numberOfThreads):
-                         customSpinCount.has_value()?*customSpinCount:
-                         10} // If no number of threads or custom spin count was defined, we will default to a spin count of 10.
+    : _engine{ makeEngine(numberOfThreads, customSpinCount) }
     {}
 
     ~LockFreeQueue() = default;
@@ -44,8 +104,8 @@ public:
      *
      *  The purpose of the "push" function is to push data into the queue.
      *
-     *  If there is no space, the thread will return false and will not
-     *  wait for space to become available.
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
      *
      *  However, once a space has been claimed, access to the queue is
      *  released and other threads can use the queue while the data is
@@ -55,63 +115,145 @@ public:
      */
     bool push(QueueItemT bufferItem) {
 
-        size_t newTail{};
-        bool keepTrying{ true };
-        SleepGranularity sleepDuration{ sleepDurationStart };
-        std::optional<size_t> pushIndex{ std::nullopt };
+        if (!_engine.push(std::move(bufferItem))) {
+            return false;
+        }
 
-        _pendingData.fetch_add(2, std::memory_order_relaxed); // We are going to add data in the queue.
-                                                              // We intentionally use 2 here in order to 
-                                                              // also use the atomic to prevent memory 
-                                                              // reordering in what follows.
+        announceData();
 
-        do
-        {
-            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+        return true;
+    }
 
-                newTail = (_tail.load(std::memory_order_relaxed) + 1) % bufferSize; // Calculate the new tail
+    /** Push data into the queue, applying the overflow policy if it is full.
+     *
+     *  The purpose of the "offer" function is to let producers degrade
+     *  gracefully under overload instead of spinning on a failing push.
+     *  While there is space it behaves like push. Otherwise, depending on
+     *  the policy set with setOverflowPolicy:
+     *
+     *    Reject     -> returns Full, like push returning false.
+     *    DropNewest -> discards the data and returns Dropped.
+     *    DropOldest -> pops and discards the oldest data until the data fits,
+     *                  and returns Success. Single consumer queues can not pop
+     *                  from a producer, and drop the newest data instead.
+     *    EarlyDrop  -> discards the data and returns Dropped, even before the
+     *                  queue is full: from the earlyDropFrom fill ratio on, the
+     *                  odds of a drop grow linearly with the depth of the queue.
+     *    Block      -> sleeps until a pop frees space, and returns Timeout
+     *                  once the timeout passed.
+     *
+     *  Every outcome but Success and Closed is counted in overflowStatistics.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     *
+     *  @return Success if the data was pushed, Closed if the queue is closed,
+     *          otherwise the outcome of the policy.
+     */
+    QueueStatus offer(QueueItemT bufferItem) {
 
-                if (newTail != _head.load(std::memory_order_relaxed)) { // When _tail + 1 == _head we can not add.
+        OverflowAction action = _overflowAction.load(std::memory_order_relaxed);
 
-                    if (!_isBusy.at(_tail.load(std::memory_order_relaxed)
-                                         ).exchange(true, std::memory_order_relaxed)) { // Check that the index is not busy
+        if (action == OverflowAction::EarlyDrop && dropEarly()) {
+            _droppedEarly.fetch_add(1, std::memory_order_relaxed);
+            return QueueStatus::Dropped;
+        }
 
-                        pushIndex = _tail.load(std::memory_order_relaxed);
-                        _tail.store(newTail, std::memory_order_relaxed);
+        if (_engine.push(bufferItem)) { // Copy, the policy may still need the item.
+            announceData();
+            return QueueStatus::Success;
+        }
 
-                        keepTrying = false;
-                    }
-                }
-                else {
-                    keepTrying = false;
-                }
+        if (isClosed()) {
+            return QueueStatus::Closed;
+        }
 
-                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
-                                                                   // threads to update the indexes
-            }
+        if (action == OverflowAction::DropOldest && singleConsumer) {
+            action = OverflowAction::DropNewest;
+        }
 
-            if (keepTrying) {
-                sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
-            }
-        } while (keepTrying); // Do work until tail is updated and we can push the data
+        switch (action) {
+        case OverflowAction::Reject:
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return QueueStatus::Full;
 
-        if (pushIndex.has_value()) {
+        case OverflowAction::DropOldest:
+            return pushDroppingOldest(bufferItem);
 
-            _buffer.at(*pushIndex) = bufferItem;
+        case OverflowAction::Block:
+            return pushBlocking(bufferItem);
 
-            _pendingData.fetch_sub(1, std::memory_order_acq_rel); // We succesfully pushed data. Decrement the counter to 
-                                                                  // what it should be and also use the atomic to prevent 
-                                                                  // memory reordering.
-                                                                  // Use memory_order_acq_rel to prevent read/writes move.
+        case OverflowAction::EarlyDrop:
+            _droppedEarly.fetch_add(1, std::memory_order_relaxed); // Full, the odds of a drop are 1.
+            return QueueStatus::Dropped;
 
-            _isBusy.at(*pushIndex).store(false, std::memory_order_relaxed); // Flag that we are done with the index
+        case OverflowAction::DropNewest:
+        default:
+            _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return QueueStatus::Dropped;
+        }
+    }
+
+    /** Set how offer handles a full queue.
+     *
+     *  The policy can be changed while the queue is in use, the offers
+     *  running at the same time may apply either policy.
+     *
+     *  @arg policy - the action to take and its parameters.
+     */
+    void setOverflowPolicy(const OverflowPolicy& policy) {
+
+        double from = std::clamp(policy.earlyDropFrom, 0.0, 1.0);
+
+        _earlyDropDepth.store(static_cast<size_t>(from * capacity), std::memory_order_relaxed);
+        _blockTimeout.store(policy.timeout.count(), std::memory_order_relaxed);
+        _overflowAction.store(policy.action, std::memory_order_relaxed);
+    }
+
+    /** Get what the overflow policy did so far.
+     *
+     * @return the counters of every overflow outcome.
+     */
+    OverflowStatistics overflowStatistics() {
+        return OverflowStatistics{ _rejected.load(std::memory_order_relaxed),
+                                   _droppedNewest.load(std::memory_order_relaxed),
+                                   _droppedOldest.load(std::memory_order_relaxed),
+                                   _droppedEarly.load(std::memory_order_relaxed),
+                                   _blocked.load(std::memory_order_relaxed),
+                                   _timedOut.load(std::memory_order_relaxed) };
+    }
 
-            return true; // We succesfully placed the data in the queue.
+    /** Push a batch of data into the queue.
+     *
+     *  The MPMC queue claims the spaces of the whole batch in a single visit
+     *  of its critical section, the other topologies push the items one by
+     *  one. Waiters and notifiers are woken once for the whole batch.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  0 and will not wait for space to become available.
+     *
+     *  @arg bufferItems - the data to be pushed into the queue, the pushed items are moved from.
+     *  @arg count - the number of items in bufferItems.
+     *
+     *  @return the number of items pushed, always the first ones of bufferItems.
+     */
+    size_t pushBulk(QueueItemT* bufferItems, size_t count) {
+
+        size_t pushed{ 0 };
+
+        if constexpr (requires { _engine.pushBulk(bufferItems, count); }) {
+            pushed = _engine.pushBulk(bufferItems, count);
+        }
+        else {
+            while (pushed < count && _engine.push(bufferItems[pushed])) { // Copy, a failed push must not lose the item.
+                ++pushed;
+            }
         }
 
-        _pendingData.fetch_sub(2, std::memory_order_relaxed); // We failed to add data in the queue.
+        if (pushed != 0) {
+            announceData();
+        }
 
-        return false; // We did not have space to put the data into the queue.
+        return pushed;
     }
 
     /** Pop data from the queue.
@@ -133,123 +275,963 @@ public:
      */
     bool pop(QueueItemT& popedData) {
 
-        bool keepTrying{ true };
-        SleepGranularity sleepDuration{ sleepDurationStart };
-        std::optional<size_t> popIndex{ std::nullopt };
+        if (!_engine.pop(popedData)) {
+            return false;
+        }
 
-        do
-        {
-            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+        announceSpace();
 
-                if (_head.load(std::memory_order_relaxed) !=
-                    _tail.load(std::memory_order_relaxed)) { // When head == tail we can not remove
+        return true;
+    }
 
-                    if (!_isBusy.at(_head.load(std::memory_order_relaxed)
-                                         ).exchange(true, std::memory_order_relaxed)) { // Check that the producer thread managed 
-                                                                                        // to commit data to the _head index and the 
-                                                                                        // index is now not busy.
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _engine.hasData();
+    }
+
+    /** Pop data from the queue, waiting for data until the deadline passes.
+     *
+     *  The purpose of the "popUntil" function is to let a consumer sleep
+     *  while the queue is empty. The consumer is woken as soon as data is
+     *  pushed or the queue is closed.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *  @arg deadline - the time after which to stop waiting.
+     *
+     *  @return Success if data was poped, Closed if the queue is closed and
+     *          has no more data, Timeout if the deadline passed.
+     */
+    template<typename ClockT, typename DurationT>
+    QueueStatus popUntil(QueueItemT& popedData, const std::chrono::time_point<ClockT, DurationT>& deadline) {
+
+        if (pop(popedData)) {
+            return QueueStatus::Success;
+        }
+
+        addWatcher(); // From here on, every push wakes us.
+
+        QueueStatus status = popWaiting(popedData, deadline);
+
+        removeWatcher();
+
+        return status;
+    }
+
+    /** Close the queue.
+     *
+     *  The purpose of the "close" function is to shut the queue down. Once
+     *  it returns every push fails, while the data already in the queue can
+     *  still be poped. Every waiting consumer (popUntil, asyncPop, QueueSet)
+     *  is woken, and is told the queue is closed once it has been drained.
+     *  Waiting producers (asyncPush) are resumed with a failure.
+     */
+    void close() {
+
+        _engine.close();
+
+        wakeWaiters();
+
+        _dataSignal.notifyFenced();
+        _spaceSignal.notifyFenced(); // Producers blocked in offer return Closed.
 
-                        popIndex = _head.load(std::memory_order_relaxed);
+        QueueNotifier* notifier = _notifier.load(std::memory_order_acquire);
+        if (notifier != nullptr) {
+            notifier->notify();
+        }
+    }
 
-                        _head.store((_head.load(std::memory_order_relaxed) + 1) % bufferSize,
-                            std::memory_order_relaxed); // Update the head;
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _engine.isClosed();
+    }
+
+    /** Measure the time consumers waited for producers preempted in the middle of a copy.
+     *
+     *  Only the MPMC queue lets a consumer claim an index which is still
+     *  being written, and measures the wait.
+     *
+     * @return the stall statistics of the engine.
+     */
+    auto stallStatistics() requires requires(EngineT& engine) { engine.stallStatistics(); } {
+        return _engine.stallStatistics();
+    }
+
+    /** Set the notifier to call after every successful push.
+     *
+     *  A queue has a single notifier, which can be shared between several
+     *  queues (eg. by a QueueSet). Passing nullptr removes the notifier.
+     *
+     *  @arg notifier - the notifier to call, it must outlive its use by the queue.
+     */
+    void setNotifier(QueueNotifier* notifier) {
+
+        QueueNotifier* previous = _notifier.exchange(notifier, std::memory_order_acq_rel);
+
+        if (previous == nullptr && notifier != nullptr) {
+            addWatcher(); // The pushes call the notifier from here on.
+        }
+        else if (previous != nullptr && notifier == nullptr) {
+            removeWatcher();
+        }
+    }
+
+    /** Move data from this queue into another one.
+     *
+     *  The purpose of the "drainInto" function is to rebalance a backlog
+     *  without a pop and a push per item. Between two MPMC queues, runs of
+     *  data are claimed on this queue and spaces reserved on the other one
+     *  in a single visit of each critical section, and the data is copied
+     *  from space to space (with memcpy for trivially copyable data). Other
+     *  topologies move the data item by item.
+     *
+     *  The data keeps its order, and the function stops once max items were
+     *  moved, this queue is empty or the other one is full. Between two MPMC
+     *  queues, if producers fill the other queue while a run is being moved,
+     *  what did not fit is pushed back to the tail of this queue. Other
+     *  topologies only pop an item once the other queue has space for it,
+     *  and wait for space if producers of the other queue took it meanwhile.
+     *  Pushing back would make the calling thread a second producer of a
+     *  single producer queue, or wait on itself as the only consumer. An
+     *  item poped while the other queue is closed is pushed back only if
+     *  this queue is MPMC, and dropped otherwise.
+     *
+     *  @arg other - the queue to move the data into.
+     *  @arg max - the maximum number of items to move.
+     *
+     *  @return the number of items moved.
+     */
+    template<size_t otherSize, ProducerPolicy OtherProducersT, ConsumerPolicy OtherConsumersT>
+    size_t drainInto(LockFreeQueue<QueueItemT, otherSize, OtherProducersT, OtherConsumersT>& other, size_t max) {
 
-                        keepTrying = false;
+        if (static_cast<void*>(&other) == static_cast<void*>(this)) {
+            return 0;
+        }
+
+        size_t moved{ 0 };
+
+        if constexpr (requires(size_t first) { _engine.claimRun(max, first); other._engine.claimSpaces(max, first); }) {
+
+            while (moved < max) {
+
+                size_t wanted = std::min(max - moved, other._engine.freeSpace()); // Do not claim more than fits.
+                size_t sourceFirst{};
+                size_t targetFirst{};
+
+                size_t claimed = wanted == 0 ? 0 : _engine.claimRun(wanted, sourceFirst);
+                if (claimed == 0) {
+                    break;
+                }
+
+                size_t reserved = other._engine.claimSpaces(claimed, targetFirst);
+
+                copyRun(other._engine, sourceFirst, targetFirst, reserved);
+
+                other._engine.publishClaimed(targetFirst, reserved);
+
+                for (size_t i = 0; i < claimed; ++i) {
+
+                    if (i >= reserved) {
+                        QueueItemT leftover = std::move(_engine.claimedItem(sourceFirst + i));
+                        _engine.releaseClaimed(sourceFirst + i);
+                        pushBack(leftover);
+                        continue;
                     }
+
+                    _engine.releaseClaimed(sourceFirst + i);
                 }
-                else {
-                    keepTrying = false;
+
+                moved += reserved;
+
+                if (reserved != claimed) {
+                    break; // The other queue is full.
+                }
+            }
+
+            if (moved != 0) {
+                other.announceData();
+            }
+
+            announceSpace();
+        }
+        else {
+
+            QueueItemT item{};
+
+            while (moved < max && other._engine.freeSpace() != 0 && pop(item)) { // Only take what fits.
+
+                while (!other.push(item)) {
+
+                    if (other.isClosed()) {
+                        if constexpr (!singleProducer && !singleConsumer) {
+                            pushBack(item); // Other consumers free the space it waits for.
+                        }
+                        return moved;
+                    }
+
+                    std::this_thread::yield(); // Producers of the other queue took the space, wait for its consumers.
                 }
 
-                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
-                                                                   // threads to update the indexes
+                ++moved;
             }
+        }
 
-            if (keepTrying) {
-                sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
+        return moved;
+    }
+
+    /** Swap the data of two queues.
+     *
+     *  Both queues must be quiescent: no thread may push or pop until the
+     *  function returns. The closed state, notifier and waiters stay with
+     *  each queue, and are woken once the data has been swapped.
+     *
+     *  @arg other - the queue to swap the data with.
+     */
+    void swapContents(LockFreeQueue& other) {
+
+        if (&other == this) {
+            return;
+        }
+
+        _engine.swapContents(other._engine);
+
+        announceData();
+        other.announceData();
+    }
+
+    /** An awaitable which pops data from the queue.
+     *
+     *  If there is no data, the awaiting coroutine is suspended onto a
+     *  lock-free waiter list. The next thread to push data pops it on
+     *  behalf of the coroutine and schedules it on its executor.
+     *
+     *  The result is empty if the queue was closed and drained.
+     */
+    class PopAwaiter : public WaiterNode<PopAwaiter> {
+    public:
+        PopAwaiter(LockFreeQueue& queue, CoroutineExecutor& executor) : _queue{ queue } {
+            this->executor = &executor;
+        }
+
+        PopAwaiter(const PopAwaiter&) = delete;
+        PopAwaiter& operator=(const PopAwaiter&) = delete;
+
+        bool await_ready() {
+            _hasItem = _queue.pop(_item);
+            return _hasItem || (_queue.isClosed() && !_queue.hasData());
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+            LockFreeQueue& queue = _queue; // Once pushed, this awaiter may be resumed and destroyed by another thread.
+            queue.addWatcher(); // Withdrawn by the thread which serves us.
+            queue._popWaiters.push(this);
+            queue.announceWaiters(); // Data might have been pushed before we were added to the list.
+        }
+
+        std::optional<QueueItemT> await_resume() {
+            if (!_hasItem) {
+                return std::nullopt;
             }
-        } while (keepTrying); // Do work until head is updated and there is no more data to pop in the queue
+            return std::move(_item);
+        }
 
-        if (popIndex.has_value()) {
+    private:
+        friend class LockFreeQueue;
 
-            popedData = _buffer.at(*popIndex);
+        LockFreeQueue& _queue;
+        QueueItemT _item{}; // the poped data
+        bool _hasItem{ false }; // false if the queue was closed and drained
+    };
 
-            _pendingData.fetch_sub(1, std::memory_order_acq_rel); // We removed data from the queue.
-                                                                  // Use memory_order_acq_rel to prevent read/writes move.
+    /** An awaitable which pushes data into the queue.
+     *
+     *  If there is no space, the awaiting coroutine is suspended onto a
+     *  lock-free waiter list. The next thread to pop data pushes the data
+     *  on behalf of the coroutine and schedules it on its executor.
+     *
+     *  The result is false if the queue was closed before the data was pushed.
+     */
+    class PushAwaiter : public WaiterNode<PushAwaiter> {
+    public:
+        PushAwaiter(LockFreeQueue& queue, CoroutineExecutor& executor, QueueItemT bufferItem)
+        : _queue{ queue }, _item{ std::move(bufferItem) } {
+            this->executor = &executor;
+        }
 
-            _isBusy.at(*popIndex).store(false, std::memory_order_relaxed); // Flag that we are done with the index
+        PushAwaiter(const PushAwaiter&) = delete;
+        PushAwaiter& operator=(const PushAwaiter&) = delete;
 
-            return true; // We succesfully poped data.
+        bool await_ready() {
+            _pushed = _queue.push(_item);
+            return _pushed || _queue.isClosed();
         }
 
-        return false; // There was no new data available.
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+            LockFreeQueue& queue = _queue; // Once pushed, this awaiter may be resumed and destroyed by another thread.
+            queue.addWatcher(); // Withdrawn by the thread which serves us.
+            queue._pushWaiters.push(this);
+            queue.announceWaiters(); // Space might have been freed before we were added to the list.
+        }
+
+        bool await_resume() const noexcept {
+            return _pushed;
+        }
+
+    private:
+        friend class LockFreeQueue;
+
+        LockFreeQueue& _queue;
+        QueueItemT _item; // the data to push
+        bool _pushed{ false }; // false if the queue was closed
+    };
+
+    /** Pop data from the queue, suspending the coroutine until data is available.
+     *
+     *  eg. std::optional<QueueItemT> data = co_await queue.asyncPop(executor);
+     *
+     *  @arg executor - the executor the coroutine is resumed on if it had to wait.
+     */
+    PopAwaiter asyncPop(CoroutineExecutor& executor) {
+        return PopAwaiter{ *this, executor };
     }
 
-    /** Check if there is data in the queue.
+    /** Push data into the queue, suspending the coroutine until space is available.
      *
-     * @return true if there is data in the queue, false otherwise.
+     *  eg. bool pushed = co_await queue.asyncPush(executor, data);
+     *
+     *  @arg executor - the executor the coroutine is resumed on if it had to wait.
+     *  @arg bufferItem - the data to be pushed into the queue.
      */
-    bool hasData() {
-        return _pendingData.load(std::memory_order_acquire) != 0;
+    PushAwaiter asyncPush(CoroutineExecutor& executor, QueueItemT bufferItem) {
+        return PushAwaiter{ *this, executor, std::move(bufferItem) };
+    }
+
+    /** A staging buffer owned by one producer thread.
+     *
+     *  The purpose of the "ProducerHandle" is to keep a hot producer off
+     *  the shared indexes: items are staged locally and handed to the queue
+     *  with pushBulk once the buffer is full, once the oldest staged item
+     *  has waited longer than maxDelay, or when flush is called. This costs
+     *  up to maxDelay of extra latency.
+     *
+     *  The delay is only checked when the handle is used, so a producer
+     *  going idle must call flush (or flushExpired). The destructor flushes
+     *  whatever is left, waiting for space unless the queue is closed.
+     */
+    class ProducerHandle {
+    public:
+        ProducerHandle(LockFreeQueue& queue, size_t batchSize, std::chrono::nanoseconds maxDelay)
+        : _queue{ queue }, _staged(batchSize == 0 ? 1 : batchSize), _maxDelay{ maxDelay } {}
+
+        ~ProducerHandle() {
+            while (!flush() && !_queue.isClosed()) {
+                std::this_thread::yield(); // Wait for the consumers to make space.
+            }
+        }
+
+        ProducerHandle(const ProducerHandle&) = delete;
+        ProducerHandle& operator=(const ProducerHandle&) = delete;
+
+        /** Stage data for the queue.
+         *
+         *  If the staging buffer is full and the queue has no space for it,
+         *  or the queue is closed, the thread will return false and will not
+         *  wait for space to become available.
+         *
+         *  @arg bufferItem - the data to be pushed into the queue.
+         */
+        bool push(QueueItemT bufferItem) {
+
+            if (_queue.isClosed()) {
+                return false;
+            }
+
+            if (_count == _staged.size()) {
+
+                flush();
+
+                if (_count == _staged.size()) {
+                    return false; // Not a single staged item fitted in the queue.
+                }
+            }
+
+            if (_count == 0) {
+                _oldest = std::chrono::steady_clock::now();
+            }
+
+            _staged[_count++] = std::move(bufferItem);
+
+            if (_count == _staged.size()) {
+                flush();
+            }
+            else {
+                flushExpired();
+            }
+
+            return true;
+        }
+
+        /** Hand every staged item to the queue.
+         *
+         *  @return true if nothing is left staged, false if the queue ran out of space.
+         */
+        bool flush() {
+
+            if (_count == 0) {
+                return true;
+            }
+
+            size_t pushed = _queue.pushBulk(_staged.data(), _count);
+
+            if (pushed != 0) {
+                std::move(_staged.begin() + pushed, _staged.begin() + _count, _staged.begin()); // Keep the order of the rest.
+                _count -= pushed;
+            }
+
+            return _count == 0;
+        }
+
+        /** Hand the staged items to the queue if the oldest one waited longer than maxDelay.
+         *
+         *  @return true if nothing is left staged, false otherwise.
+         */
+        bool flushExpired() {
+            if (_count != 0 && std::chrono::steady_clock::now() - _oldest >= _maxDelay) {
+                return flush();
+            }
+            return _count == 0;
+        }
+
+        /** The number of items staged and not yet pushed into the queue.
+         */
+        size_t staged() const {
+            return _count;
+        }
+
+    private:
+        LockFreeQueue& _queue;
+        std::vector<QueueItemT> _staged; // the items waiting to be pushed, in order
+        size_t _count{ 0 }; // the number of staged items
+        std::chrono::nanoseconds _maxDelay; // the longest an item may stay staged
+        std::chrono::steady_clock::time_point _oldest{}; // when the oldest staged item was staged
+    };
+
+    /** Create a staging buffer for one producer thread.
+     *
+     *  eg. auto handle = queue.producerHandle(32, std::chrono::microseconds{ 50 });
+     *
+     *  @arg batchSize - the number of items staged before they are pushed.
+     *  @arg maxDelay - the longest an item may stay staged.
+     */
+    ProducerHandle producerHandle(size_t batchSize, std::chrono::nanoseconds maxDelay) {
+        return ProducerHandle{ *this, batchSize, maxDelay };
+    }
+
+    /** A run of data owned by one consumer thread.
+     *
+     *  The purpose of the "ConsumerHandle" is to keep a hot consumer off
+     *  the shared indexes: the MPMC queue claims up to batchSize items in a
+     *  single visit of its critical section, and the handle hands them out
+     *  one by one, reading them in place. The next item is prefetched while
+     *  the caller processes the current one, which hides the memory latency
+     *  of a large buffer. The other topologies pop item by item, since their
+     *  pop already avoids the shared critical section.
+     *
+     *  Claimed items are no longer counted by hasData. Items still claimed
+     *  when the handle is destroyed are pushed back to the tail of the
+     *  queue, and are dropped if the queue was closed meanwhile.
+     */
+    class ConsumerHandle {
+    public:
+        ConsumerHandle(LockFreeQueue& queue, size_t batchSize)
+        : _queue{ queue }, _batchSize{ batchSize == 0 ? 1 : batchSize } {}
+
+        ~ConsumerHandle() {
+            QueueItemT leftover{};
+            while (_cursor != _claimed && pop(leftover)) { // Only hand out the current run, never claim a new one.
+                while (!_queue.push(leftover) && !_queue.isClosed()) {
+                    std::this_thread::yield(); // Wait for the consumers to make space.
+                }
+            }
+        }
+
+        ConsumerHandle(const ConsumerHandle&) = delete;
+        ConsumerHandle& operator=(const ConsumerHandle&) = delete;
+
+        /** Pop data from the claimed run, claiming a new run when it is used up.
+         *
+         *  If there is no data, the thread will return false and will not
+         *  wait for data to become available.
+         *
+         *  @arg popedData - the location to put the extracted data into.
+         *
+         *  @return true if there was data available, false otherwise.
+         */
+        bool pop(QueueItemT& popedData) {
+
+            if constexpr (requires { _queue._engine.claimRun(_batchSize, _first); }) {
+
+                if (_cursor == _claimed) {
+
+                    _cursor = 0;
+                    _claimed = _queue._engine.claimRun(_batchSize, _first);
+
+                    if (_claimed == 0) {
+                        return false;
+                    }
+                }
+
+                size_t index{ _first + _cursor++ };
+
+#if defined(LOCKFREEQUEUE_HAS_PREFETCH)
+                if (_cursor != _claimed) {
+                    __builtin_prefetch(&_queue._engine.claimedItem(index + 1)); // Start loading the next item now.
+                }
+#endif
+
+                popedData = std::move(_queue._engine.claimedItem(index));
+                _queue._engine.releaseClaimed(index);
+
+                if (_cursor == _claimed) {
+                    _queue.announceSpace(); // Hand the freed run over, only once none of it is busy.
+                }
+
+                return true;
+            }
+            else {
+                return _queue.pop(popedData);
+            }
+        }
+
+        /** The number of claimed items not handed out yet.
+         */
+        size_t claimed() const {
+            return _claimed - _cursor;
+        }
+
+    private:
+        LockFreeQueue& _queue;
+        size_t _batchSize; // the maximum number of items claimed at once
+        size_t _first{ 0 }; // the index of the first space of the run
+        size_t _claimed{ 0 }; // the number of spaces in the run
+        size_t _cursor{ 0 }; // the next space of the run to hand out
+    };
+
+    /** Create a run of data for one consumer thread.
+     *
+     *  eg. auto handle = queue.consumerHandle(32);
+     *
+     *  @arg batchSize - the maximum number of items claimed at once.
+     */
+    ConsumerHandle consumerHandle(size_t batchSize) {
+        return ConsumerHandle{ *this, batchSize };
     }
 
 private:
-    /** Put the thread to sleep.
+    /** What wakeWaiters did on behalf of suspended coroutines.
+     */
+    struct ServedWaiters {
+        bool pushed{ false }; // data was pushed for an asyncPush
+        bool poped{ false };  // data was poped for an asyncPop
+    };
+
+    /** Wake whoever waits for the data just pushed.
+     */
+    void announceData() {
+
+        if (!mayHaveWatchers()) {
+            return;
+        }
+
+        ServedWaiters served = wakeWaiters(); // Hand the new data to a suspended coroutine, if any.
+
+        notifyData(); // wakeWaiters issued the fence.
+
+        if (served.poped) {
+            _spaceSignal.notifyFenced(); // A suspended consumer freed a space.
+        }
+    }
+
+    /** Wake whoever waits for the space just freed.
+     */
+    void announceSpace() {
+
+        if (!mayHaveWatchers()) {
+            return;
+        }
+
+        ServedWaiters served = wakeWaiters(); // Hand the freed space to a suspended coroutine, if any.
+
+        _spaceSignal.notifyFenced(); // Wake the producers blocked in offer, wakeWaiters issued the fence.
+
+        if (served.pushed) {
+            notifyData(); // A suspended producer filled the space.
+        }
+    }
+
+    /** Serve the coroutines which might have missed the last push or pop, and announce what they did.
+     */
+    void announceWaiters() {
+
+        ServedWaiters served = wakeWaiters();
+
+        if (served.pushed) {
+            notifyData(); // wakeWaiters issued the fence.
+        }
+
+        if (served.poped) {
+            _spaceSignal.notifyFenced(); // A suspended consumer freed a space.
+        }
+    }
+
+    /** Check if a thread, a coroutine or a notifier may wait for what was just pushed or poped.
      *
-     *  The purpose of the "backOff" function is to put the thread to sleep.
-     *  The sleep duration increases linearly until a threashold is reached.
+     *  addWatcher issues the heavy fence, so the push or pop only needs the
+     *  light one: either it sees the watcher, or the watcher sees its data
+     *  or its space.
      *
-     *  @arg sleepDuration - the current value of the sleep duration.
+     *  @return false if nobody needs to be woken.
+     */
+    bool mayHaveWatchers() {
+        asymmetricFenceLight();
+        return _watchers.load(std::memory_order_relaxed) != 0;
+    }
+
+    /** Count a thread, a coroutine or a notifier which is about to wait on the queue.
      *
-     *  @return the updated value of the sleep duration
+     *  Must be called before the waiter checks the queue one last time.
      */
-    SleepGranularity backOff(SleepGranularity sleepDuration) {
+    void addWatcher() {
+        _watchers.fetch_add(1, std::memory_order_relaxed);
+        asymmetricFenceHeavy(); // Pairs with the light fence of mayHaveWatchers.
+    }
 
-        std::this_thread::yield();
+    /** Withdraw a watcher counted by addWatcher.
+     */
+    void removeWatcher() {
+        _watchers.fetch_sub(1, std::memory_order_relaxed);
+    }
 
-        if (sleepDuration < sleepDurationStep) {
+    /** Wake the threads waiting in popUntil and the notifier.
+     *
+     *  Must be called after a sequentially consistent fence which follows the push.
+     */
+    void notifyData() {
+
+        _dataSignal.notifyFenced();
 
-            return sleepDuration + sleepDurationStep;
+        QueueNotifier* notifier = _notifier.load(std::memory_order_acquire);
+        if (notifier != nullptr) {
+            notifier->notify(); // Let whoever watches the queue know there is new data.
         }
+    }
+
+    /** Pop data from the queue, waiting for data until the deadline passes, see popUntil.
+     *
+     *  The caller must be registered as a watcher.
+     */
+    template<typename ClockT, typename DurationT>
+    QueueStatus popWaiting(QueueItemT& popedData, const std::chrono::time_point<ClockT, DurationT>& deadline) {
+
+        while (true) {
+
+            if (pop(popedData)) {
+                return QueueStatus::Success;
+            }
 
-        std::this_thread::sleep_for(sleepDuration);
+            if (isClosed()) {
 
-        return (sleepDuration < _maxSleepDuration)?
-                    sleepDuration + sleepDurationStep: // increment the sleep duration if we are below the max threashhold
-                    sleepDurationStart;                // otherwise reset the sleep duration to sleepDurationStart
+                if (!hasData()) {
+                    return QueueStatus::Closed; // Closed and drained.
+                }
+
+                std::this_thread::yield(); // A claimed push is still being copied, it will not notify us again.
+            }
+            else {
+
+                uint64_t key = _dataSignal.prepareWait();
+
+                if (hasData() || isClosed()) { // Data might have been pushed before we announced the wait.
+                    _dataSignal.cancelWait();
+                    continue;
+                }
+
+                _dataSignal.waitUntil(key, deadline);
+            }
+
+            if (ClockT::now() >= deadline) {
+                return pop(popedData) ? QueueStatus::Success : QueueStatus::Timeout;
+            }
+        }
     }
 
-    /** Approximate spins.
+    /** Decide whether EarlyDrop discards an offer at the current depth.
      *
-     *  The purpose of the "spinCount" function is to aproximate the 
-     *  number of times a consumer/producer thread is going to spin 
-     *  before going to sleep.
+     *  @return true if the offer is to be dropped.
+     */
+    bool dropEarly() {
+
+        size_t from = _earlyDropDepth.load(std::memory_order_relaxed);
+        size_t depth = capacity - std::min(capacity, _engine.freeSpace());
+
+        if (depth <= from) {
+            return false;
+        }
+
+        thread_local uint64_t random{ std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1 };
+
+        random ^= random << 13; // xorshift64, cheap and good enough to spread the drops.
+        random ^= random >> 7;
+        random ^= random << 17;
+
+        return random % (capacity - from) < depth - from;
+    }
+
+    /** Push data, poping and discarding the oldest data until it fits.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     *
+     *  @return Success, or Closed if the queue was closed meanwhile.
+     */
+    QueueStatus pushDroppingOldest(const QueueItemT& bufferItem) {
+
+        QueueItemT evicted{};
+
+        while (!_engine.push(bufferItem)) {
+
+            if (isClosed()) {
+                return QueueStatus::Closed;
+            }
+
+            if (_engine.pop(evicted)) {
+                _droppedOldest.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        announceData();
+
+        return QueueStatus::Success;
+    }
+
+    /** Push data, sleeping until space is freed or the timeout passes.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     *
+     *  @return Success, Closed if the queue was closed meanwhile, or Timeout.
+     */
+    QueueStatus pushBlocking(const QueueItemT& bufferItem) {
+
+        _blocked.fetch_add(1, std::memory_order_relaxed);
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::nanoseconds{ _blockTimeout.load(std::memory_order_relaxed) };
+
+        addWatcher(); // From here on, every pop wakes us.
+
+        QueueStatus status{ QueueStatus::Timeout };
+
+        while (true) {
+
+            uint64_t key = _spaceSignal.prepareWait();
+
+            if (_engine.hasSpace() || isClosed()) { // Space might have been freed before we announced the wait.
+                _spaceSignal.cancelWait();
+            }
+            else {
+                _spaceSignal.waitUntil(key, deadline);
+            }
+
+            if (_engine.push(bufferItem)) {
+                status = QueueStatus::Success;
+                break;
+            }
+
+            if (isClosed()) {
+                status = QueueStatus::Closed;
+                break;
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                _timedOut.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            std::this_thread::yield(); // Another producer took the space, or a claimed pop is still being copied.
+        }
+
+        removeWatcher();
+
+        if (status == QueueStatus::Success) {
+            announceData();
+        }
+
+        return status;
+    }
+
+    /** Copy a run claimed on this queue into a run of spaces claimed on another one.
      *
-     *  @arg numberOfThreads - total number of consumer+producer threads.
+     *  @arg target - the engine of the other queue.
+     *  @arg sourceFirst - the index of the first claimed space of this queue.
+     *  @arg targetFirst - the index of the first claimed space of the other queue.
+     *  @arg count - the number of items to copy.
+     */
+    template<typename TargetEngineT>
+    void copyRun(TargetEngineT& target, size_t sourceFirst, size_t targetFirst, size_t count) {
+
+        size_t copied{ 0 };
+
+        while (copied < count) {
+
+            QueueItemT* from = &_engine.claimedItem(sourceFirst + copied);
+            QueueItemT* to = &target.claimedItem(targetFirst + copied);
+
+            if constexpr (std::is_trivially_copyable_v<QueueItemT>) {
+
+                size_t length = std::min({ count - copied,
+                                           _engine.contiguousSpaces(sourceFirst + copied),
+                                           target.contiguousSpaces(targetFirst + copied) }); // Stop where either ring wraps.
+
+                std::memcpy(to, from, length * sizeof(QueueItemT));
+
+                copied += length;
+            }
+            else {
+                *to = std::move(*from);
+                ++copied;
+            }
+        }
+    }
+
+    /** Push data back into the queue, waiting for space unless the queue is closed.
+     *
+     *  @arg bufferItem - the data to push back, dropped if the queue is closed.
+     */
+    void pushBack(const QueueItemT& bufferItem) {
+        while (!push(bufferItem) && !isClosed()) {
+            std::this_thread::yield(); // Wait for the consumers to make space.
+        }
+    }
+
+    /** Build the queue algorithm of the topology.
+     *
+     *  @arg numberOfThreads - the total number of consumer+producer threads.
+     *  @arg customSpinCount - the times a thread will spin before going to sleep.
+     *
+     *  @return the queue algorithm, built in place.
+     */
+    static EngineT makeEngine(std::optional<size_t> numberOfThreads, std::optional<size_t> customSpinCount) {
+        if constexpr (std::is_same_v<EngineT, MpmcQueue<QueueItemT, bufferSize>>) {
+            return EngineT{ numberOfThreads, customSpinCount };
+        }
+        else {
+            return EngineT{};
+        }
+    }
+
+    /** Complete the operations of suspended coroutines.
+     *
+     *  The purpose of the "wakeWaiters" function is to serve suspended
+     *  coroutines for as long as there is data for the poping ones or
+     *  space for the pushing ones.
+     *
+     *  Both the waker and a coroutine adding itself to a waiter list run
+     *  this after a sequentially consistent fence, so either the waker sees
+     *  the coroutine or the coroutine sees the data/space.
      *
-     *  @return the number of times a consumer/producer thread is going 
-     *          to spin before going to sleep.
+     *  The data pushed and the space freed on behalf of coroutines must be
+     *  announced by the caller, a fence follows the last of them.
+     *
+     *  @return whether data was pushed and whether data was poped.
      */
-    int spinCount(size_t numberOfThreads) {
-        return 86.404/std::pow(numberOfThreads, 0.691); // This is an approximation based on ~10million pops per 2 minutes 
-                                                        // performance within reasonable CPU load. The approximation was 
-                                                        // derived using a 4-core CPU. This approximation will probably need 
-                                                        // to be re-evaluated based on the CPU cores.
+    ServedWaiters wakeWaiters() {
+
+        ServedWaiters served{};
+
+        while (true) {
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool closed{ _engine.isClosed() };
+            bool servePop{ !_popWaiters.empty() && (_engine.hasData() || closed) };
+            bool servePush{ !_pushWaiters.empty() && (_engine.hasSpace() || closed) };
+
+            if (!servePop && !servePush) {
+                return served; // Nobody is waiting or there is nothing to hand over.
+            }
+
+            if (servePop) {
+                PopAwaiter* waiters = _popWaiters.takeAllInOrder();
+                if (waiters != nullptr) {
+                    serveWaiters(_popWaiters, waiters,
+                                 [this, &served](PopAwaiter& waiter) {
+                                     waiter._hasItem = _engine.pop(waiter._item);
+                                     served.poped = served.poped || waiter._hasItem;
+                                     return waiter._hasItem || (_engine.isClosed() && !_engine.hasData());
+                                 });
+                }
+            }
+
+            if (servePush) {
+                PushAwaiter* waiters = _pushWaiters.takeAllInOrder();
+                if (waiters != nullptr) {
+                    serveWaiters(_pushWaiters, waiters,
+                                 [this, &served](PushAwaiter& waiter) {
+                                     waiter._pushed = _engine.push(waiter._item);
+                                     served.pushed = served.pushed || waiter._pushed;
+                                     return waiter._pushed || _engine.isClosed();
+                                 });
+                }
+            }
+        }
     }
 
-    std::array<QueueItemT, bufferSize> _buffer{}; // the ring buffer
-    std::array<std::atomic_bool, bufferSize> _isBusy{ false }; // the buffer if there is work pending on each index
-    std::atomic<size_t> _head{ 0 }; // consumer index
-    std::atomic<size_t> _tail{ 0 }; // producer index
-    std::atomic<long long> _pendingData{ 0 }; // count pending data in the queue
-    std::atomic_bool _canUpdate{ true }; // critical section protection
+    /** Complete the operations of a chain of waiters.
+     *
+     *  The chain is exclusively owned by the caller. Waiters are completed
+     *  and resumed oldest first until an operation fails, and whatever is
+     *  left of the chain is put back into the waiter list, ahead of the
+     *  waiters which arrived meanwhile, so none of them can starve.
+     *
+     *  @arg list - the list the chain was taken from.
+     *  @arg waiters - the chain of waiters, the oldest first.
+     *  @arg complete - completes the operation of a waiter, returns false on failure.
+     */
+    template<typename NodeT, typename CompleteT>
+    void serveWaiters(WaiterList<NodeT>& list, NodeT* waiters, CompleteT complete) {
+
+        while (waiters != nullptr && complete(*waiters)) {
+            NodeT* next = waiters->next;
+            removeWatcher();
+            waiters->resume(); // The waiter may be destroyed from here on.
+            waiters = next;
+        }
 
-    SleepGranularity sleepDurationStart{};   // the initial value of the sleepDuration. Adding sleepDurationStep, 
-                                             // until it reaches 1, translates to how many times we are going to 
-                                             // spin before going to sleep. eg, sleepDurationStart = -10 and 
-                                             // sleepDurationStep = 1 => we are going to spin 10 times before 
-                                             // going to sleep for some value of sleepDuration.
+        if (waiters != nullptr) {
+            list.putBackInOrder(waiters);
+        }
+    }
 
-    SleepGranularity sleepDurationStep{ 1 }; // the value by which we increment sleepDurationStart every time we spin.
-    SleepGranularity _maxSleepDuration{ 1 }; // the maximum time the thread can go to sleep for.
-};
\ No newline at end of file
+    EngineT _engine; // the queue algorithm of the topology
+    WaiterList<PopAwaiter> _popWaiters{}; // coroutines waiting for data
+    WaiterList<PushAwaiter> _pushWaiters{}; // coroutines waiting for space
+    std::atomic<QueueNotifier*> _notifier{ nullptr }; // announces pushed data to an external waiter
+    std::atomic<size_t> _watchers{ 0 }; // the waiting threads, suspended coroutines and notifier
+    QueueSignal _dataSignal{}; // wakes the threads waiting in popUntil
+    QueueSignal _spaceSignal{}; // wakes the producers blocked in offer
+    std::atomic<OverflowAction> _overflowAction{ OverflowAction::Reject }; // what offer does on a full queue
+    std::atomic<int64_t> _blockTimeout{ 0 }; // how long Block waits, in nanoseconds
+    std::atomic<size_t> _earlyDropDepth{ capacity / 2 }; // the depth from which EarlyDrop drops
+    std::atomic<size_t> _rejected{ 0 }; // the overflow counters, see OverflowStatistics
+    std::atomic<size_t> _droppedNewest{ 0 };
+    std::atomic<size_t> _droppedOldest{ 0 };
+    std::atomic<size_t> _droppedEarly{ 0 };
+    std::atomic<size_t> _blocked{ 0 };
+    std::atomic<size_t> _timedOut{ 0 };
+};
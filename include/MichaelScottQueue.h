@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <EpochReclamation.h>
+
+/** An unbounded multi-producer/multi-consumer queue of linked nodes.
+ *
+ *  The purpose of the "MichaelScottQueue" is to absorb bursts of
+ *  unpredictable size, which a fixed ring can only handle by being over
+ *  provisioned or by dropping data. It is the classic Michael & Scott
+ *  queue: producers link a node after the tail with a compare-and-swap and
+ *  consumers swing the head past a dummy node.
+ *
+ *  Nodes are retired to an EpochReclamation domain, so a node is only
+ *  reused once no thread can still be reading it, and recycled through a
+ *  free list of the thread that frees them, which saves the allocator on
+ *  steady traffic. Every thread joins the domain on its first use of the
+ *  queue and leaves when it exits, so at most maxThreads threads may have
+ *  used the queue at the same time.
+ */
+template<typename QueueItemT>
+class MichaelScottQueue {
+
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        QueueItemT item{};
+    };
+
+    using Domain = EpochReclamation<>;
+
+    /** The reclamation state, which outlives the queue while threads are still members.
+     */
+    struct Shared {
+        explicit Shared(size_t maxThreads) : domain{ maxThreads } {}
+
+        Domain domain; // reclaims the poped nodes
+        std::atomic_bool destroyed{ false }; // set once the queue is gone, so the members can leave
+    };
+
+public:
+
+    using ItemType = QueueItemT;
+
+    /** A constructor which takes the maximum number of threads as argument.
+     *
+     *  @arg maxThreads - the maximum number of threads using the queue at the same time.
+     */
+    explicit MichaelScottQueue(size_t maxThreads = 128)
+    : _shared{ std::make_shared<Shared>(maxThreads) },
+      _id{ nextQueueId().fetch_add(1, std::memory_order_relaxed) }
+    {
+        Node* dummy = new Node{};
+        _head.store(dummy, std::memory_order_relaxed);
+        _tail.store(dummy, std::memory_order_relaxed);
+    }
+
+    /** Free the nodes still in the queue.
+     *
+     *  No thread may use the queue any more.
+     */
+    ~MichaelScottQueue() {
+        _shared->destroyed.store(true, std::memory_order_release);
+
+        Node* node = _head.load(std::memory_order_acquire);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    // Make the queue non copyable.
+    MichaelScottQueue(const MichaelScottQueue&) = delete;
+    MichaelScottQueue& operator=(const MichaelScottQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  The queue grows as needed, so the data is always pushed (or
+     *  std::bad_alloc is thrown).
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        Participant& participant = threadParticipant();
+
+        Node* node = allocate(std::move(bufferItem));
+
+        auto guard = participant.pin();
+
+        while (true) {
+
+            Node* tail = _tail.load(std::memory_order_acquire);
+            Node* next = tail->next.load(std::memory_order_acquire);
+
+            if (tail != _tail.load(std::memory_order_acquire)) {
+                continue; // The tail moved, look again.
+            }
+
+            if (next != nullptr) {
+                _tail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed); // Help the
+                continue;                                                                                   // lagging push.
+            }
+
+            if (tail->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                _tail.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed); // Swing the tail,
+                return true;                                                                                   // or let others help.
+            }
+        }
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        Participant& participant = threadParticipant();
+
+        Node* head{ nullptr };
+
+        {
+            auto guard = participant.pin();
+
+            while (true) {
+
+                head = _head.load(std::memory_order_acquire);
+                Node* tail = _tail.load(std::memory_order_acquire);
+                Node* next = head->next.load(std::memory_order_acquire);
+
+                if (head != _head.load(std::memory_order_acquire)) {
+                    continue; // The head moved, look again.
+                }
+
+                if (next == nullptr) {
+                    return false; // Only the dummy node is left.
+                }
+
+                if (head == tail) {
+                    _tail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed); // Help the
+                    continue;                                                                                   // lagging push.
+                }
+
+                if (_head.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    popedData = std::move(next->item); // next is the new dummy, nobody else reads its data.
+                    break;
+                }
+            }
+        }
+
+        participant.retire(head, &recycle);
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        auto guard = threadParticipant().pin();
+        return _head.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) != nullptr;
+    }
+
+private:
+    using Participant = Domain::Participant;
+
+    /** The membership of the calling thread in the domain of one queue.
+     */
+    struct ThreadState {
+        uint64_t queueId; // the queue the membership belongs to
+        std::shared_ptr<Shared> shared; // keeps the domain alive for as long as the thread is a member
+        std::unique_ptr<Participant> participant;
+    };
+
+    /** The nodes the calling thread freed, kept for reuse.
+     */
+    struct NodeCache {
+        static constexpr size_t maxNodes{ 1024 };
+
+        ~NodeCache() {
+            for (Node* node : nodes) {
+                delete node;
+            }
+        }
+
+        std::vector<Node*> nodes{};
+    };
+
+    /** The ids of the queues, which unlike their addresses are never reused.
+     */
+    static std::atomic<uint64_t>& nextQueueId() {
+        static std::atomic<uint64_t> id{ 0 };
+        return id;
+    }
+
+    static NodeCache& nodeCache() {
+        thread_local NodeCache cache{};
+        return cache;
+    }
+
+    /** Find the membership of the calling thread, joining the domain on the first use.
+     *
+     *  @return the participant of the calling thread.
+     */
+    Participant& threadParticipant() {
+
+        nodeCache(); // Construct the cache first, so it outlives the memberships which recycle into it on thread exit.
+
+        thread_local std::vector<ThreadState> states{};
+
+        for (ThreadState& state : states) {
+            if (state.queueId == _id) {
+                return *state.participant;
+            }
+        }
+
+        std::erase_if(states, [](const ThreadState& state) { // Leave the queues which are gone.
+            return state.shared->destroyed.load(std::memory_order_acquire);
+        });
+
+        states.push_back(ThreadState{ _id, _shared, std::unique_ptr<Participant>{ new Participant{ _shared->domain.join() } } });
+
+        return *states.back().participant;
+    }
+
+    /** Get a node, from the free list of the calling thread if it has one.
+     *
+     *  @arg bufferItem - the data of the node.
+     */
+    static Node* allocate(QueueItemT&& bufferItem) {
+
+        NodeCache& cache = nodeCache();
+
+        if (cache.nodes.empty()) {
+            Node* node = new Node{};
+            node->item = std::move(bufferItem);
+            return node;
+        }
+
+        Node* node = cache.nodes.back();
+        cache.nodes.pop_back();
+
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->item = std::move(bufferItem);
+
+        return node;
+    }
+
+    /** Put a node nobody can read any more on the free list of the calling thread.
+     *
+     *  @arg node - the node.
+     */
+    static void recycle(void* node) {
+
+        NodeCache& cache = nodeCache();
+
+        if (cache.nodes.size() < NodeCache::maxNodes) {
+            cache.nodes.push_back(static_cast<Node*>(node));
+        }
+        else {
+            delete static_cast<Node*>(node);
+        }
+    }
+
+    alignas(cacheLineSize) std::atomic<Node*> _head{ nullptr }; // the dummy node, the data starts after it
+    alignas(cacheLineSize) std::atomic<Node*> _tail{ nullptr }; // the last node, or the one before it
+    std::shared_ptr<Shared> _shared; // reclaims the poped nodes
+    uint64_t _id; // identifies the queue in the memberships of the threads
+};
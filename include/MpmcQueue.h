@@ -0,0 +1,795 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <optional>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include <Sequence.h>
+
+/** A multi-producer/multi-consumer queue.
+ *
+ *  The purpose of the "MpmcQueue" is to serve any number of producers and
+ *  consumers. The indexes are updated in a short critical section, guarded
+ *  by _canUpdate, and the data is copied in and out of the claimed spaces
+ *  outside of it. This is the engine of LockFreeQueue<QueueItemT, bufferSize>.
+ *
+ *  A consumer claims the index at the head even if its producer is still
+ *  copying into it, and waits for the copy outside the critical section,
+ *  so a producer preempted in the middle of a copy only holds up the one
+ *  consumer of its index (see awaitWriter and stallStatistics).
+ *
+ *  A push and a pop which both find the critical section taken may meet in
+ *  an exchanger instead of backing off, as long as the queue is empty (see
+ *  handOff), which is the common case when the queue runs near empty.
+ *
+ *  One space is always left empty, so the queue holds bufferSize - 1 items.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class MpmcQueue {
+
+    using SleepGranularity = std::chrono::nanoseconds;
+
+public:
+
+    using ItemType = QueueItemT;
+
+    MpmcQueue() = delete;
+
+    /** A constructor which takes the total number of consumer+producer threads
+     *  as argument. This will subsequently be used to define how many times a 
+     *  thread will spin before going to sleep.
+     * 
+     *  If a custom spin count is provided, the number of threads is ignored and 
+     *  the custom spin count is used, as is, instead.
+     *
+     *  @arg numberOfThreads - the total number of consumer+producer threads.
+     *  @arg customSpinCount - the times a thread will spin before going to sleep.
+     */
+    MpmcQueue(std::optional<size_t> numberOfThreads = std::nullopt,
+              std::optional<size_t> customSpinCount = std::nullopt)
+    : sleepDurationStart{numberOfThreads.has_value()?-spinCount(*numberOfThreads):
+                         customSpinCount.has_value()?*customSpinCount:
+                         10} // If no number of threads or custom spin count was defined, we will default to a spin count of 10.
+    {}
+
+    ~MpmcQueue() = default;
+
+    // Make the queue non copyable.
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  The purpose of the "push" function is to push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
+     *
+     *  However, once a space has been claimed, access to the queue is
+     *  released and other threads can use the queue while the data is
+     *  copied into the claimed space.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        size_t newTail{};
+        bool keepTrying{ true };
+        SleepGranularity sleepDuration{ sleepDurationStart };
+        std::optional<size_t> pushIndex{ std::nullopt };
+
+        _pendingData.fetch_add(2, std::memory_order_relaxed); // We are going to add data in the queue.
+                                                              // We intentionally use 2 here in order to 
+                                                              // also use the atomic to prevent memory 
+                                                              // reordering in what follows.
+
+        do
+        {
+            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+
+                newTail = (_tail.load(std::memory_order_relaxed) + 1) % bufferSize; // Calculate the new tail
+
+                if (_closed.load(std::memory_order_relaxed)) { // A closed queue accepts no more data.
+                    keepTrying = false;
+                }
+                else if (newTail != _head.load(std::memory_order_relaxed)) { // When _tail + 1 == _head we can not add.
+
+                    if (claimForWriting(_tail.load(std::memory_order_relaxed))) { // Check that no consumer is still reading the index
+
+                        pushIndex = _tail.load(std::memory_order_relaxed);
+                        _tail.store(newTail, std::memory_order_relaxed);
+
+                        keepTrying = false;
+                    }
+                }
+                else {
+                    keepTrying = false;
+                }
+
+                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
+                                                                   // threads to update the indexes
+            }
+
+            if (keepTrying) {
+
+                if (handOff(bufferItem)) { // A consumer is waiting on an empty queue, give it the data directly.
+                    _pendingData.fetch_sub(2, std::memory_order_relaxed);
+                    return true;
+                }
+
+                sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
+            }
+        } while (keepTrying); // Do work until tail is updated and we can push the data
+
+        if (pushIndex.has_value()) {
+
+            _buffer.at(*pushIndex) = std::move(bufferItem);
+
+            _pendingData.fetch_sub(1, std::memory_order_acq_rel); // We succesfully pushed data. Decrement the counter to 
+                                                                  // what it should be and also use the atomic to prevent 
+                                                                  // memory reordering.
+                                                                  // Use memory_order_acq_rel to prevent read/writes move.
+
+            _slotStates.at(*pushIndex).store(SlotState::Ready, std::memory_order_release); // Hand the data to its consumer
+
+            return true; // We succesfully placed the data in the queue.
+        }
+
+        _pendingData.fetch_sub(2, std::memory_order_relaxed); // We failed to add data in the queue.
+
+        return false; // We did not have space to put the data into the queue.
+    }
+
+    /** Push a batch of data into the queue.
+     *
+     *  The purpose of the "pushBulk" function is to claim up to count
+     *  consecutive spaces in a single visit of the critical section, so a
+     *  batch costs the shared indexes as much as a single push.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  0 and will not wait for space to become available. The data is pushed
+     *  in order, and the data that did not fit is left untouched.
+     *
+     *  @arg bufferItems - the data to be pushed into the queue.
+     *  @arg count - the number of items in bufferItems.
+     *
+     *  @return the number of items pushed, always the first ones of bufferItems.
+     */
+    size_t pushBulk(QueueItemT* bufferItems, size_t count) {
+
+        size_t first{};
+        size_t claimed = claimSpaces(count, first);
+
+        for (size_t i = 0; i < claimed; ++i) {
+            _buffer.at((first + i) % bufferSize) = std::move(bufferItems[i]);
+        }
+
+        publishClaimed(first, claimed);
+
+        return claimed;
+    }
+
+    /** Claim a run of consecutive spaces, without copying anything into them.
+     *
+     *  The purpose of the "claimSpaces" function is to let a producer
+     *  reserve up to count spaces in a single visit of the critical section
+     *  and fill them in place, through claimedItem. The data only becomes
+     *  visible to the consumers once publishClaimed is called.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  0 and will not wait for space to become available.
+     *
+     *  @arg count - the maximum number of spaces to claim.
+     *  @arg first - set to the index of the first claimed space.
+     *
+     *  @return the number of claimed spaces, from first onwards.
+     */
+    size_t claimSpaces(size_t count, size_t& first) {
+
+        if (count == 0) {
+            return 0;
+        }
+
+        size_t claimed{ 0 };
+        bool keepTrying{ true };
+        SleepGranularity sleepDuration{ sleepDurationStart };
+
+        _pendingData.fetch_add(2 * count, std::memory_order_relaxed); // We are going to add count items, see push.
+
+        do
+        {
+            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+
+                bool isBusy{ false };
+
+                if (!_closed.load(std::memory_order_relaxed)) { // A closed queue accepts no more data.
+
+                    first = _tail.load(std::memory_order_relaxed);
+                    size_t tail{ first };
+
+                    while (claimed < count &&
+                           (tail + 1) % bufferSize != _head.load(std::memory_order_relaxed)) { // When _tail + 1 == _head we can not add.
+
+                        if (!claimForWriting(tail)) { // Stop at the first index a consumer is still reading
+                            isBusy = true;
+                            break;
+                        }
+
+                        ++claimed;
+                        tail = (tail + 1) % bufferSize;
+                    }
+
+                    _tail.store(tail, std::memory_order_relaxed);
+                }
+
+                keepTrying = isBusy && claimed == 0; // Like push, only retry if the next index is still being read.
+
+                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
+                                                                   // threads to update the indexes
+            }
+
+            if (keepTrying) {
+                sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
+            }
+        } while (keepTrying); // Do work until tail is updated
+
+        if (claimed != count) {
+            _pendingData.fetch_sub(2 * (count - claimed), std::memory_order_relaxed); // The rest did not fit.
+        }
+
+        return claimed;
+    }
+
+    /** Hand a run of spaces claimed by claimSpaces, and filled, to the consumers.
+     *
+     *  @arg first - the index of the first claimed space.
+     *  @arg count - the number of claimed spaces.
+     */
+    void publishClaimed(size_t first, size_t count) {
+
+        if (count == 0) {
+            return;
+        }
+
+        _pendingData.fetch_sub(count, std::memory_order_acq_rel); // We succesfully pushed the batch, one decrement 
+                                                                  // for all of it also keeps the writes to the 
+                                                                  // spaces before the flags below.
+
+        for (size_t i = 0; i < count; ++i) {
+            _slotStates.at((first + i) % bufferSize).store(SlotState::Ready, std::memory_order_release); // Hand the data to its consumer
+        }
+    }
+
+    /** Pop data from the queue.
+     *
+     *  The purpose of the "pop" function is to extract data from the queue.
+     *
+     *  The assigned thread will claim the space containing the next available
+     *  data. If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  However, once a space has been claimed, access to the queue is
+     *  released and other threads can use the queue while the data is
+     *  returned back to the caller.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return return true if there was data available to return back
+     *          to the caller, otherwise return false.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        bool keepTrying{ true };
+        bool inFlight{ false };
+        SleepGranularity sleepDuration{ sleepDurationStart };
+        std::optional<size_t> popIndex{ std::nullopt };
+
+        do
+        {
+            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+
+                if (_head.load(std::memory_order_relaxed) !=
+                    _tail.load(std::memory_order_relaxed)) { // When head == tail we can not remove
+
+                    popIndex = _head.load(std::memory_order_relaxed);
+
+                    inFlight = !claimForReading(*popIndex); // Take the index even if its producer is still writing to it,
+                                                            // so the other consumers can move on to the next indexes.
+
+                    _head.store((_head.load(std::memory_order_relaxed) + 1) % bufferSize,
+                        std::memory_order_relaxed); // Update the head;
+                }
+
+                keepTrying = false;
+
+                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
+                                                                   // threads to update the indexes
+            }
+
+            if (keepTrying) {
+
+                std::optional<bool> exchanged = awaitHandOff(popedData); // Wait for a producer in an exchanger rather than asleep.
+
+                if (exchanged.value_or(false)) {
+                    return true;
+                }
+
+                if (!exchanged.has_value()) {
+                    sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
+                }
+            }
+        } while (keepTrying); // Do work until head is updated and there is no more data to pop in the queue
+
+        if (popIndex.has_value()) {
+
+            if (inFlight) {
+                awaitWriter(*popIndex); // Only this consumer waits for the preempted producer.
+            }
+
+            popedData = _buffer.at(*popIndex);
+
+            _pendingData.fetch_sub(1, std::memory_order_acq_rel); // We removed data from the queue.
+                                                                  // Use memory_order_acq_rel to prevent read/writes move.
+
+            _slotStates.at(*popIndex).store(SlotState::Free, std::memory_order_release); // Hand the index back to the producers
+
+            return true; // We succesfully poped data.
+        }
+
+        return false; // There was no new data available.
+    }
+
+    /** Claim a run of consecutive data, without copying it out.
+     *
+     *  The purpose of the "claimRun" function is to let a consumer take up
+     *  to count items in a single visit of the critical section and read
+     *  them in place. Every claimed space stays busy until it is handed
+     *  back with releaseClaimed, so producers wrapping around to it wait.
+     *
+     *  If there is no data, the thread will return 0 and will not wait for
+     *  data to become available.
+     *
+     *  @arg count - the maximum number of items to claim.
+     *  @arg first - set to the index of the first claimed space.
+     *
+     *  @return the number of claimed spaces, from first onwards.
+     */
+    size_t claimRun(size_t count, size_t& first) {
+
+        size_t claimed{ 0 };
+        bool keepTrying{ count != 0 };
+        bool inFlight{ false };
+        SleepGranularity sleepDuration{ sleepDurationStart };
+
+        while (keepTrying)
+        {
+            if (_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access and check index positions.
+
+                first = _head.load(std::memory_order_relaxed);
+                size_t head{ first };
+
+                while (claimed < count &&
+                       head != _tail.load(std::memory_order_relaxed)) { // When head == tail we can not remove
+
+                    if (!claimForReading(head)) { // A producer is still writing to the index.
+                        if (claimed == 0) {       // Take it alone and wait for it outside, like pop,
+                            inFlight = true;      // or stop before it.
+                            claimed = 1;
+                            head = (head + 1) % bufferSize;
+                        }
+                        break;
+                    }
+
+                    ++claimed;
+                    head = (head + 1) % bufferSize;
+                }
+
+                _head.store(head, std::memory_order_relaxed);
+
+                keepTrying = false;
+
+                _canUpdate.store(true, std::memory_order_release); // Allow access to the critical section for other 
+                                                                   // threads to update the indexes
+            }
+
+            if (keepTrying) {
+                sleepDuration = backOff(sleepDuration); // If we keep retrying, try not to overload the CPU
+            }
+        }
+
+        if (inFlight) {
+            awaitWriter(first);
+        }
+
+        if (claimed != 0) {
+            _pendingData.fetch_sub(claimed, std::memory_order_acq_rel); // The claimed data now belongs to the consumer.
+        }
+
+        return claimed;
+    }
+
+    /** Access a space claimed by claimRun or claimSpaces.
+     *
+     *  @arg index - the index of the space.
+     *
+     *  @return the data of the space.
+     */
+    QueueItemT& claimedItem(size_t index) {
+        return _buffer[index % bufferSize];
+    }
+
+    /** Count the spaces between an index and the end of the buffer.
+     *
+     *  @arg index - the index of a space.
+     *
+     *  @return the number of spaces from index onwards which are contiguous in memory.
+     */
+    static constexpr size_t contiguousSpaces(size_t index) {
+        return bufferSize - index % bufferSize;
+    }
+
+    /** Hand a space claimed by claimRun back to the producers.
+     *
+     *  @arg index - the index of the space, its data must not be used any more.
+     */
+    void releaseClaimed(size_t index) {
+        _slotStates.at(index % bufferSize).store(SlotState::Free, std::memory_order_release); // Hand the index back to the producers
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _pendingData.load(std::memory_order_acquire) != 0;
+    }
+
+    /** Count the data handed from a producer to a consumer through the exchangers.
+     *
+     * @return the number of eliminated push/pop pairs.
+     */
+    size_t eliminations() {
+        return _eliminations.load(std::memory_order_relaxed);
+    }
+
+    /** The time consumers spent waiting for producers preempted in the middle of a copy.
+     */
+    struct StallStatistics {
+        size_t count{ 0 }; // the number of pops which found their index still being written
+        std::chrono::nanoseconds total{ 0 }; // the time they waited, in total
+        std::chrono::nanoseconds longest{ 0 }; // the longest wait
+    };
+
+    /** Measure the head-of-line stalls seen so far.
+     *
+     * @return the stall statistics.
+     */
+    StallStatistics stallStatistics() {
+        return StallStatistics{ _stallCount.load(std::memory_order_relaxed),
+                                std::chrono::nanoseconds{ _stallNanoseconds.load(std::memory_order_relaxed) },
+                                std::chrono::nanoseconds{ _longestStall.load(std::memory_order_relaxed) } };
+    }
+
+    /** Check if there is space in the queue.
+     *
+     *  The indexes are read outside the critical section, so the answer is
+     *  only a hint.
+     *
+     * @return true if there seems to be space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return (_tail.load(std::memory_order_relaxed) + 1) % bufferSize !=
+                _head.load(std::memory_order_relaxed);
+    }
+
+    /** Count the free spaces of the queue.
+     *
+     *  The indexes are read outside the critical section, so the answer is
+     *  only a hint.
+     *
+     * @return the number of items the queue seems to have room for.
+     */
+    size_t freeSpace() {
+        return (_head.load(std::memory_order_relaxed) + bufferSize - 1 -
+                _tail.load(std::memory_order_relaxed)) % bufferSize;
+    }
+
+    /** Swap the data of two queues.
+     *
+     *  Both queues must be quiescent: no thread may use either of them
+     *  until the function returns. The closed state stays with each queue.
+     *
+     *  @arg other - the queue to swap the data with.
+     */
+    void swapContents(MpmcQueue& other) {
+
+        std::swap(_buffer, other._buffer);
+
+        swapQuiescent(_head, other._head);
+        swapQuiescent(_tail, other._tail);
+        swapQuiescent(_pendingData, other._pendingData);
+
+        for (size_t index = 0; index < bufferSize; ++index) {
+            swapQuiescent(_slotStates[index], other._slotStates[index]); // The data moved, and so did the Ready states.
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Publish the swap to whoever uses the queues next.
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped.
+     */
+    void close() {
+
+        SleepGranularity sleepDuration{ sleepDurationStart };
+
+        while (!_canUpdate.exchange(false, std::memory_order_acquire)) { // Gain access so no push can claim a space after this.
+            sleepDuration = backOff(sleepDuration);
+        }
+
+        _closed.store(true, std::memory_order_relaxed);
+
+        _canUpdate.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+private:
+    /** The states of an index of the ring.
+     */
+    enum class SlotState : uint8_t {
+        Free,    // a producer may claim the index
+        Writing, // a producer is copying data in, a consumer may already have claimed it and wait
+        Ready,   // the data is published
+        Reading  // a consumer is copying the data out
+    };
+
+    /** Claim an index for a producer, in the critical section.
+     *
+     *  @arg index - the index at the tail.
+     *
+     *  @return true if it was free, false if a consumer is still reading it.
+     */
+    bool claimForWriting(size_t index) {
+        SlotState expected{ SlotState::Free };
+        return _slotStates.at(index).compare_exchange_strong(expected, SlotState::Writing,
+                                                             std::memory_order_acquire,   // After the consumer's last read.
+                                                             std::memory_order_relaxed);
+    }
+
+    /** Claim an index for a consumer, in the critical section.
+     *
+     *  @arg index - the index at the head.
+     *
+     *  @return true if its data is published, false if its producer is still writing it.
+     */
+    bool claimForReading(size_t index) {
+        SlotState expected{ SlotState::Ready };
+        return _slotStates.at(index).compare_exchange_strong(expected, SlotState::Reading,
+                                                             std::memory_order_acquire,   // After the producer's write.
+                                                             std::memory_order_relaxed);
+    }
+
+    /** Wait, outside the critical section, for the producer of a claimed index to publish its data.
+     *
+     *  The purpose of the "awaitWriter" function is to keep a producer
+     *  which was preempted in the middle of its copy from stalling every
+     *  consumer: the consumer which claimed its index waits here, while the
+     *  others keep poping the next indexes. The wait is measured, see
+     *  stallStatistics.
+     *
+     *  @arg index - the claimed index.
+     */
+    void awaitWriter(size_t index) {
+
+        std::atomic<SlotState>& state = _slotStates.at(index % bufferSize);
+
+        auto begin = std::chrono::steady_clock::now();
+        SleepGranularity sleepDuration{ sleepDurationStart };
+
+        while (state.load(std::memory_order_acquire) != SlotState::Ready) {
+            sleepDuration = backOff(sleepDuration);
+        }
+
+        state.store(SlotState::Reading, std::memory_order_relaxed);
+
+        long long stall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+
+        _stallCount.fetch_add(1, std::memory_order_relaxed);
+        _stallNanoseconds.fetch_add(stall, std::memory_order_relaxed);
+
+        long long longest = _longestStall.load(std::memory_order_relaxed);
+        while (stall > longest && !_longestStall.compare_exchange_weak(longest, stall, std::memory_order_relaxed)) {}
+    }
+
+    /** The states of an exchanger.
+     */
+    enum class Exchange : uint8_t {
+        Free,      // nobody uses the exchanger
+        Waiting,   // a consumer waits for data
+        Claimed,   // a producer is checking it may hand its data over
+        Delivered  // the data is in the exchanger, for the waiting consumer
+    };
+
+    /** A place where a consumer and a producer, both backing off, meet without touching the ring.
+     */
+    struct alignas(cacheLineSize) Exchanger {
+        std::atomic<Exchange> state{ Exchange::Free };
+        QueueItemT item{};
+    };
+
+    static constexpr size_t numberOfExchangers{ 4 };
+    static constexpr size_t exchangeWaits{ 8 }; // how many times a consumer yields while waiting in an exchanger
+
+    /** Give the data to a consumer waiting in an exchanger, if the queue is empty.
+     *
+     *  The purpose of the "handOff" function is the elimination back-off:
+     *  a push and a pop which both failed to enter the critical section
+     *  complete each other instead of sleeping. It is only allowed while
+     *  the queue holds no data and no other push is under way, as if the
+     *  push and the pop had gone through the ring back to back, so the
+     *  order of the queue is kept.
+     *
+     *  @arg bufferItem - the data, moved from only if it was handed over.
+     *
+     *  @return true if a consumer took the data, false otherwise.
+     */
+    bool handOff(QueueItemT& bufferItem) {
+
+        for (size_t i = 0; i < numberOfExchangers; ++i) {
+
+            Exchanger& exchanger = _exchangers[(exchangerHint() + i) % numberOfExchangers];
+
+            Exchange expected{ Exchange::Waiting };
+            if (exchanger.state.load(std::memory_order_relaxed) != expected ||
+                !exchanger.state.compare_exchange_strong(expected, Exchange::Claimed, std::memory_order_acquire)) {
+                continue;
+            }
+
+            if (_closed.load(std::memory_order_seq_cst) ||
+                _pendingData.load(std::memory_order_seq_cst) != 2) { // Only our own push is counted: the queue is empty.
+
+                exchanger.state.store(Exchange::Waiting, std::memory_order_release); // Let the consumer go on waiting.
+                return false;
+            }
+
+            exchanger.item = std::move(bufferItem);
+            exchanger.state.store(Exchange::Delivered, std::memory_order_release);
+
+            _eliminations.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Wait in an exchanger for a producer to hand its data over.
+     *
+     *  @arg popedData - the location to put the data into.
+     *
+     *  @return true if a producer handed data over, false if nobody came,
+     *          and nullopt if no exchanger was free to wait in.
+     */
+    std::optional<bool> awaitHandOff(QueueItemT& popedData) {
+
+        Exchanger& exchanger = _exchangers[exchangerHint()];
+
+        Exchange expected{ Exchange::Free };
+        if (exchanger.state.load(std::memory_order_relaxed) != expected ||
+            !exchanger.state.compare_exchange_strong(expected, Exchange::Waiting, std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        for (size_t wait = 0; wait < exchangeWaits; ++wait) {
+
+            if (exchanger.state.load(std::memory_order_acquire) == Exchange::Delivered) {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+
+        while (true) {
+
+            expected = Exchange::Waiting;
+            if (exchanger.state.compare_exchange_weak(expected, Exchange::Free, std::memory_order_acquire)) {
+                return false; // Nobody came, leave.
+            }
+
+            if (expected == Exchange::Delivered) {
+                popedData = std::move(exchanger.item);
+                exchanger.state.store(Exchange::Free, std::memory_order_release);
+                return true;
+            }
+
+            std::this_thread::yield(); // A producer is checking the queue, it will deliver or let us go.
+        }
+    }
+
+    /** Pick the exchanger a thread starts from, so threads spread over them.
+     */
+    static size_t exchangerHint() {
+        thread_local size_t hint{ std::hash<std::thread::id>{}(std::this_thread::get_id()) % numberOfExchangers };
+        return hint;
+    }
+
+    /** Put the thread to sleep.
+     *
+     *  The purpose of the "backOff" function is to put the thread to sleep.
+     *  The sleep duration increases linearly until a threashold is reached.
+     *
+     *  @arg sleepDuration - the current value of the sleep duration.
+     *
+     *  @return the updated value of the sleep duration
+     */
+    SleepGranularity backOff(SleepGranularity sleepDuration) {
+
+        std::this_thread::yield();
+
+        if (sleepDuration < sleepDurationStep) {
+
+            return sleepDuration + sleepDurationStep;
+        }
+
+        std::this_thread::sleep_for(sleepDuration);
+
+        return (sleepDuration < _maxSleepDuration)?
+                    sleepDuration + sleepDurationStep: // increment the sleep duration if we are below the max threashhold
+                    sleepDurationStart;                // otherwise reset the sleep duration to sleepDurationStart
+    }
+
+    /** Approximate spins.
+     *
+     *  The purpose of the "spinCount" function is to aproximate the 
+     *  number of times a consumer/producer thread is going to spin 
+     *  before going to sleep.
+     *
+     *  @arg numberOfThreads - total number of consumer+producer threads.
+     *
+     *  @return the number of times a consumer/producer thread is going 
+     *          to spin before going to sleep.
+     */
+    int spinCount(size_t numberOfThreads) {
+        return 86.404/std::pow(numberOfThreads, 0.691); // This is an approximation based on ~10million pops per 2 minutes 
+                                                        // performance within reasonable CPU load. The approximation was 
+                                                        // derived using a 4-core CPU. This approximation will probably need 
+                                                        // to be re-evaluated based on the CPU cores.
+    }
+
+    std::array<QueueItemT, bufferSize> _buffer{}; // the ring buffer
+    std::array<std::atomic<SlotState>, bufferSize> _slotStates{}; // who works on each index, see SlotState
+    std::atomic<size_t> _head{ 0 }; // consumer index
+    std::atomic<size_t> _tail{ 0 }; // producer index
+    std::atomic<long long> _pendingData{ 0 }; // count pending data in the queue
+    std::atomic_bool _canUpdate{ true }; // critical section protection
+    std::atomic_bool _closed{ false }; // set once the queue is closed, protected by _canUpdate
+    std::array<Exchanger, numberOfExchangers> _exchangers{}; // the elimination back-off
+    std::atomic<size_t> _eliminations{ 0 }; // the data handed over through the exchangers
+    std::atomic<size_t> _stallCount{ 0 }; // the pops which waited for a producer
+    std::atomic<long long> _stallNanoseconds{ 0 }; // the time they waited
+    std::atomic<long long> _longestStall{ 0 }; // the longest wait, in nanoseconds
+
+    SleepGranularity sleepDurationStart{};   // the initial value of the sleepDuration. Adding sleepDurationStep, 
+                                             // until it reaches 1, translates to how many times we are going to 
+                                             // spin before going to sleep. eg, sleepDurationStart = -10 and 
+                                             // sleepDurationStep = 1 => we are going to spin 10 times before 
+                                             // going to sleep for some value of sleepDuration.
+
+    SleepGranularity sleepDurationStep{ 1 }; // the value by which we increment sleepDurationStart every time we spin.
+    SleepGranularity _maxSleepDuration{ 1 }; // the maximum time the thread can go to sleep for.
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <thread>
+
+#include <Sequence.h>
+
+/** A multi-producer/single-consumer queue.
+ *
+ *  The purpose of the "MpscQueue" is to give the single consumer of a
+ *  many-to-one topology (eg. a log or metrics aggregator) a contention
+ *  free path. Producers claim a space with a compare_exchange on the tail,
+ *  only once they saw the space is free (the bounded queue of Vyukov), and
+ *  the consumer only uses plain loads and stores: no read-modify-write and
+ *  no critical section.
+ *
+ *  Every space carries a sequence number telling whose turn it is:
+ *  sequence == n means the space is free for the producer of ticket n,
+ *  sequence == n + 1 means it holds the data of ticket n.
+ *
+ *  Only one thread may pop. Closing the queue sets the top bit of the
+ *  tail, so the compare_exchange of a producer fails once it is closed.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class MpscQueue {
+public:
+
+    using ItemType = QueueItemT;
+
+    MpscQueue() {
+        for (size_t i = 0; i < bufferSize; ++i) {
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() = default;
+
+    // Make the queue non copyable.
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        size_t ticket = _tail.value.load(std::memory_order_relaxed);
+
+        while (true) {
+
+            if (ticket & closedBit) {
+                return false; // A closed queue accepts no more data.
+            }
+
+            auto lag = static_cast<std::ptrdiff_t>(
+                           _buffer[ticket % bufferSize].sequence.load(std::memory_order_acquire) - ticket);
+
+            if (lag < 0) {
+                return false; // The consumer has not freed the space of the next ticket yet.
+            }
+
+            if (lag == 0) {
+                if (_tail.value.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed)) {
+                    break; // The space is ours.
+                }
+                continue; // Another producer took the ticket, or the queue was closed: ticket was reloaded.
+            }
+
+            ticket = _tail.value.load(std::memory_order_relaxed); // Another producer already used that ticket.
+        }
+
+        Slot& slot = _buffer[ticket % bufferSize];
+
+        slot.item = std::move(bufferItem);
+        slot.sequence.store(ticket + 1, std::memory_order_release); // Hand the space to the consumer.
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If the next data has not been written yet, the thread will return
+     *  false and will not wait for it.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        size_t head = _head.value.load(std::memory_order_relaxed);
+        Slot& slot = _buffer[head % bufferSize];
+
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false; // Empty, or the producer is still copying the data.
+        }
+
+        popedData = std::move(slot.item);
+        slot.sequence.store(head + bufferSize, std::memory_order_release); // Hand the space to the producer of the next lap.
+
+        _head.value.store(head + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     *  Data claimed by a producer but not yet copied counts as data.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return (_tail.value.load(std::memory_order_acquire) & ~closedBit) != _head.value.load(std::memory_order_acquire);
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true if there is space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return (_tail.value.load(std::memory_order_acquire) & ~closedBit) -
+                _head.value.load(std::memory_order_acquire) < bufferSize;
+    }
+
+    /** Count the free spaces of the queue.
+     *
+     * @return the number of items the queue has room for.
+     */
+    size_t freeSpace() {
+        size_t head = _head.value.load(std::memory_order_acquire);
+        size_t used = (_tail.value.load(std::memory_order_acquire) & ~closedBit) - head;
+        return used < bufferSize ? bufferSize - used : 0; // The head may have moved on since it was read.
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped.
+     */
+    void close() {
+        _tail.value.fetch_or(closedBit, std::memory_order_acq_rel);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return (_tail.value.load(std::memory_order_acquire) & closedBit) != 0;
+    }
+
+    /** Swap the data of two queues.
+     *
+     *  Both queues must be quiescent: no thread may use either of them
+     *  until the function returns. The closed state stays with each queue.
+     *
+     *  @arg other - the queue to swap the data with.
+     */
+    void swapContents(MpscQueue& other) {
+
+        for (size_t i = 0; i < bufferSize; ++i) {
+            swapQuiescent(_buffer[i].sequence, other._buffer[i].sequence);
+            std::swap(_buffer[i].item, other._buffer[i].item);
+        }
+
+        size_t tail = _tail.value.load(std::memory_order_relaxed);
+        size_t otherTail = other._tail.value.load(std::memory_order_relaxed);
+
+        _tail.value.store((otherTail & ~closedBit) | (tail & closedBit), std::memory_order_relaxed); // Keep our closed bit.
+        other._tail.value.store((tail & ~closedBit) | (otherTail & closedBit), std::memory_order_relaxed);
+
+        swapQuiescent(_head.value, other._head.value);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Publish the swap to whoever uses the queues next.
+    }
+
+private:
+    static constexpr size_t closedBit{ ~(~size_t{ 0 } >> 1) }; // the top bit of the tail, set once the queue is closed
+
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 }; // whose turn it is to use the space
+        QueueItemT item{};
+    };
+
+    Sequence _tail{}; // the next ticket given to a producer
+    Sequence _head{}; // the next ticket read by the consumer
+    std::array<Slot, bufferSize> _buffer{}; // the ring buffer
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/** What a queue does with data offered while it is full.
+ */
+enum class OverflowAction : uint8_t {
+    Reject,     // fail the offer, the producer keeps the data (the behaviour of push)
+    DropNewest, // discard the offered data
+    DropOldest, // discard the oldest data of the queue to make room
+    EarlyDrop,  // discard the offered data with a probability growing with the depth of the queue
+    Block       // wait for space, until the timeout passes
+};
+
+/** How a queue handles overload.
+ *
+ *  eg. queue.setOverflowPolicy({ OverflowAction::Block, std::chrono::milliseconds{ 5 } });
+ */
+struct OverflowPolicy {
+    OverflowAction action{ OverflowAction::Reject };
+    std::chrono::nanoseconds timeout{ 0 }; // how long Block waits for space
+    double earlyDropFrom{ 0.5 }; // the fill ratio from which EarlyDrop starts dropping, it drops everything once full
+};
+
+/** What the overflow policy of a queue did so far.
+ */
+struct OverflowStatistics {
+    size_t rejected{ 0 };      // offers failed by Reject
+    size_t droppedNewest{ 0 }; // offered data discarded by DropNewest
+    size_t droppedOldest{ 0 }; // queued data discarded by DropOldest
+    size_t droppedEarly{ 0 };  // offered data discarded by EarlyDrop
+    size_t blocked{ 0 };       // offers which had to wait for space
+    size_t timedOut{ 0 };      // offers which waited until the timeout
+};
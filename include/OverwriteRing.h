@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <type_traits>
+
+#include <Sequence.h>
+
+/** A lossy multi-producer/multi-consumer ring which keeps the newest data.
+ *
+ *  The purpose of the "OverwriteRing" is to serve metrics and sampling,
+ *  where a full queue should lose its oldest data rather than make the
+ *  producer fail or wait. A push claims a ticket with a compare_exchange on
+ *  the tail, which fails once the queue is closed, and writes space
+ *  ticket % bufferSize whether or not the data there was read: a slow
+ *  consumer never holds a producer back.
+ *
+ *  Every space is a seqlock. Its sequence holds the ticket of the data it
+ *  carries, and is odd while a producer writes it. A consumer copies the
+ *  data and checks the sequence did not move, so it never returns a torn
+ *  item. The data is copied word by word through relaxed atomics, which is
+ *  why items must be trivially copyable.
+ *
+ *  A consumer which finds a newer ticket than its head in the space was
+ *  lapped: it moves the head up to the oldest ticket which may still be
+ *  in the ring and adds the skipped tickets to the dropped counter. Every
+ *  ticket is thus either poped or counted as dropped, exactly once.
+ *
+ *  A producer only waits for another producer which, a full lap behind it,
+ *  is still copying into the same space.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class OverwriteRing {
+
+    static_assert(std::is_trivially_copyable_v<QueueItemT>, "Items are copied while they may be overwritten.");
+    static_assert(bufferSize > 0, "The ring needs at least one space.");
+
+    using Word = std::uint64_t;
+
+    static constexpr size_t numberOfWords{ (sizeof(QueueItemT) + sizeof(Word) - 1) / sizeof(Word) };
+    static constexpr size_t closedBit{ size_t{ 1 } << (std::numeric_limits<size_t>::digits - 1) };
+
+    using Words = std::array<Word, numberOfWords>;
+
+    struct alignas(cacheLineSize) Space {
+        std::atomic<size_t> sequence{ 0 }; // (ticket + 1) * 2, plus 1 while the data is written
+        std::array<std::atomic<Word>, numberOfWords> words{}; // the data
+    };
+
+public:
+
+    using ItemType = QueueItemT;
+
+    OverwriteRing() = default;
+    ~OverwriteRing() = default;
+
+    // Make the queue non copyable.
+    OverwriteRing(const OverwriteRing&) = delete;
+    OverwriteRing& operator=(const OverwriteRing&) = delete;
+
+    /** Push data into the queue, overwriting the oldest data if the ring is full.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     *
+     *  @return false if the queue is closed, true otherwise.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        size_t ticket = _tail.value.load(std::memory_order_relaxed);
+
+        do {
+            if (ticket & closedBit) {
+                return false; // A closed queue accepts no more data, and its tail stays put.
+            }
+        } while (!_tail.value.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed));
+
+        Space& space = _spaces[ticket % bufferSize];
+        size_t mark = ticket + 1;
+        size_t sequence = space.sequence.load(std::memory_order_relaxed);
+
+        while (true) {
+
+            if ((sequence >> 1) >= mark) {
+                return true; // A newer ticket took the space: this data is already overwritten.
+            }
+
+            if (sequence & 1) { // A producer a lap behind is still copying.
+                std::this_thread::yield();
+                sequence = space.sequence.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (space.sequence.compare_exchange_weak(sequence, mark * 2 + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_release); // The sequence is odd before any word changes.
+
+        Words words{};
+        std::memcpy(words.data(), static_cast<const void*>(&bufferItem), sizeof(QueueItemT));
+        for (size_t i = 0; i < numberOfWords; ++i) {
+            space.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        space.sequence.store(mark * 2, std::memory_order_release);
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, or the oldest data is still being written, the
+     *  thread will return false and will not wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+        size_t lost{ 0 };
+        return pop(popedData, lost);
+    }
+
+    /** Pop data from the queue, reporting the data this consumer found overwritten.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *  @arg lost - set to the number of items skipped because the consumer was lapped.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData, size_t& lost) {
+
+        lost = 0;
+        size_t head = _head.value.load(std::memory_order_acquire);
+
+        while (true) {
+
+            Space& space = _spaces[head % bufferSize];
+            size_t mark = head + 1;
+            size_t sequence = space.sequence.load(std::memory_order_acquire);
+
+            if ((sequence >> 1) < mark || sequence == mark * 2 + 1) {
+                return false; // The ticket of the head is not written yet.
+            }
+
+            if (sequence == mark * 2) {
+
+                Words words{};
+                for (size_t i = 0; i < numberOfWords; ++i) {
+                    words[i] = space.words[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire); // Read the words before checking them.
+
+                if (space.sequence.load(std::memory_order_relaxed) != sequence) {
+                    continue; // Overwritten while copying: the head was lapped.
+                }
+
+                if (_head.value.compare_exchange_strong(head, mark, std::memory_order_acq_rel)) {
+                    std::memcpy(static_cast<void*>(&popedData), words.data(), sizeof(QueueItemT)); // Trivially copyable, if not trivial.
+                    return true;
+                }
+
+                continue; // Another consumer took it, head is reloaded.
+            }
+
+            // A newer ticket is in the space: skip to the oldest one which may still be in the ring.
+            size_t tail = _tail.value.load(std::memory_order_relaxed) & ~closedBit;
+            size_t oldest = std::max(mark, tail > bufferSize ? tail - bufferSize : 0);
+
+            if (_head.value.compare_exchange_strong(head, oldest, std::memory_order_acq_rel)) {
+                _dropped.value.fetch_add(oldest - head, std::memory_order_relaxed);
+                lost += oldest - head;
+                head = oldest;
+            }
+        }
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return (_tail.value.load(std::memory_order_acquire) & ~closedBit) > _head.value.load(std::memory_order_acquire);
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true, a push always finds a space.
+     */
+    bool hasSpace() {
+        return true;
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped.
+     */
+    void close() {
+        _tail.value.fetch_or(closedBit, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _tail.value.load(std::memory_order_acquire) & closedBit;
+    }
+
+    /** Get the number of items overwritten before a consumer reached them.
+     *
+     * @return the number of dropped items.
+     */
+    size_t dropped() {
+        return _dropped.value.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    Sequence _tail{}; // the next ticket to push, the top bit is set once closed
+    Sequence _head{}; // the next ticket to pop
+    Sequence _dropped{}; // the number of tickets skipped by lapped consumers
+    std::array<Space, bufferSize> _spaces{}; // the ring
+};
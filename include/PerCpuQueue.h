@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define LOCKFREEQUEUE_HAS_RSEQ 1
+#endif
+
+#include <MpscQueue.h>
+#include <Sequence.h>
+
+/** Get the CPU the calling thread is running on.
+ *
+ *  Reads the cpu_id the kernel keeps up to date in the rseq area glibc
+ *  registers for every thread, which costs a plain load. When rseq is not
+ *  registered (old kernel or glibc, or disabled with the glibc.pthread.rseq
+ *  tunable) it falls back to sched_getcpu, and off Linux to a number
+ *  derived from the thread id.
+ *
+ *  The answer may be stale as soon as it is returned: the thread can be
+ *  migrated at any time.
+ *
+ *  @return the CPU number.
+ */
+inline size_t currentCpu() {
+
+#if defined(LOCKFREEQUEUE_HAS_RSEQ)
+    if (__rseq_size != 0) {
+        auto* area = reinterpret_cast<const volatile struct rseq*>(
+            static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+        int cpu = static_cast<int>(area->cpu_id);
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu);
+        }
+    }
+#endif
+
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<size_t>(cpu);
+    }
+#endif
+
+    thread_local size_t pseudoCpu{ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+    return pseudoCpu;
+}
+
+/** A multi-producer/multi-consumer queue sharded by CPU.
+ *
+ *  The purpose of the "PerCpuQueue" is to give preemptible producers, such
+ *  as logging and telemetry call sites in application threads, a push which
+ *  never shares a cache line with producers running on other CPUs. Every
+ *  CPU owns a shard (an MpscQueue) and a push goes to the shard of the CPU
+ *  the thread is running on, so the tail it claims is only ever touched by
+ *  the threads of that CPU and stays in its cache. Consumers sweep the
+ *  shards, each starting where it found data last, and skip a shard which
+ *  another consumer is draining.
+ *
+ *  A full restartable sequence, which would let the push commit with a
+ *  plain store and no read-modify-write, needs a per-architecture assembly
+ *  commit block. This queue only uses rseq to read the CPU number and keeps
+ *  the compare_exchange of the MpscQueue push: a thread migrated or
+ *  preempted between reading its CPU and pushing still pushes correctly,
+ *  it merely shares a shard with another CPU for that one push, and in the
+ *  common case the compare_exchange is uncontended and succeeds at once.
+ *
+ *  Ordering:
+ *  - the data of one shard is poped in the order it was pushed.
+ *  - the data of one producer keeps its order only while the thread stays
+ *    on one CPU; there is no order across shards.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class PerCpuQueue {
+
+    struct alignas(cacheLineSize) Shard {
+        MpscQueue<QueueItemT, bufferSize> queue{};
+        alignas(cacheLineSize) std::atomic_bool draining{ false }; // held by the consumer popping from the shard
+    };
+
+public:
+
+    using ItemType = QueueItemT;
+
+    /** A constructor which takes the number of shards as argument.
+     *
+     *  @arg numberOfShards - the number of shards, by default one per configured CPU.
+     */
+    explicit PerCpuQueue(size_t numberOfShards = configuredCpus())
+    : _numberOfShards{ numberOfShards == 0 ? 1 : numberOfShards },
+      _shards{ std::make_unique<Shard[]>(_numberOfShards) }
+    {}
+
+    ~PerCpuQueue() = default;
+
+    // Make the queue non copyable.
+    PerCpuQueue(const PerCpuQueue&) = delete;
+    PerCpuQueue& operator=(const PerCpuQueue&) = delete;
+
+    /** Push data into the shard of the current CPU.
+     *
+     *  If the shard has no space, or the queue is closed, the thread will
+     *  return false and will not wait for space to become available, even
+     *  if other shards have some.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+        return localShard().queue.push(std::move(bufferItem));
+    }
+
+    /** Pop data from the queue, sweeping the shards.
+     *
+     *  If no shard has data, or every shard with data is being drained by
+     *  another consumer, the thread will return false and will not wait for
+     *  data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        thread_local size_t hint{ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+
+        for (size_t i = 0; i < _numberOfShards; ++i) {
+
+            size_t index = (hint + i) % _numberOfShards;
+            Shard& shard = _shards[index];
+
+            if (!shard.queue.hasData() || shard.draining.load(std::memory_order_relaxed) ||
+                shard.draining.exchange(true, std::memory_order_acquire)) {
+                continue; // Empty, or another consumer is on it.
+            }
+
+            bool poped = shard.queue.pop(popedData);
+            shard.draining.store(false, std::memory_order_release);
+
+            if (poped) {
+                hint = index; // Come back while it has data.
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in any shard, false otherwise.
+     */
+    bool hasData() {
+        for (size_t i = 0; i < _numberOfShards; ++i) {
+            if (_shards[i].queue.hasData()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Check if there is space in the queue.
+     *
+     *  Only a hint: the thread may push from another CPU.
+     *
+     * @return true if there is space in the shard of the current CPU, false otherwise.
+     */
+    bool hasSpace() {
+        return localShard().queue.hasSpace();
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped.
+     */
+    void close() {
+        for (size_t i = 0; i < _numberOfShards; ++i) {
+            _shards[i].queue.close();
+        }
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _shards[_numberOfShards - 1].queue.isClosed(); // The last shard to be closed.
+    }
+
+    /** Get the number of shards.
+     *
+     * @return the number of shards.
+     */
+    size_t numberOfShards() const {
+        return _numberOfShards;
+    }
+
+private:
+
+    Shard& localShard() {
+        return _shards[currentCpu() % _numberOfShards];
+    }
+
+    static size_t configuredCpus() {
+#if defined(__linux__)
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        if (cpus > 0) {
+            return static_cast<size_t>(cpus);
+        }
+#endif
+        return std::thread::hardware_concurrency();
+    }
+
+    size_t _numberOfShards; // the number of shards
+    std::unique_ptr<Shard[]> _shards; // one shard per CPU
+};
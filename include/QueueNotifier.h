@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/** The interface a queue uses to announce that data was pushed.
+ *
+ *  A queue calls "notify" after every successful push, so implementations
+ *  must keep the case where nobody is waiting as cheap as possible.
+ */
+class QueueNotifier {
+public:
+    virtual ~QueueNotifier() = default;
+
+    /** Called by a queue after data has been pushed into it.
+     */
+    virtual void notify() = 0;
+};
+
+/** A shared notification word that threads can block on.
+ *
+ *  The purpose of the "QueueSignal" is to let a thread sleep until one of
+ *  the queues it watches announces new data, without the producers paying
+ *  for a system call when nobody sleeps.
+ *
+ *  A waiter must follow the protocol below so that a notification can not
+ *  be lost between checking the queues and going to sleep:
+ *
+ *      auto key = signal.prepareWait();
+ *      if (<condition>) { signal.cancelWait(); }
+ *      else { signal.wait(key); }
+ */
+class QueueSignal : public QueueNotifier {
+public:
+
+    QueueSignal() = default;
+    ~QueueSignal() override = default;
+
+    // Make the signal non copyable.
+    QueueSignal(const QueueSignal&) = delete;
+    QueueSignal& operator=(const QueueSignal&) = delete;
+
+    /** Wake every thread waiting on the signal.
+     *
+     *  When nobody is waiting this costs a fence and a load.
+     */
+    void notify() override {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Order the pushed data before reading the sleepers.
+        notifyFenced();
+    }
+
+    /** Same as "notify", for callers which already issued a sequentially
+     *  consistent fence after publishing their data.
+     */
+    void notifyFenced() {
+        if (_sleepers.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            _epoch.fetch_add(1, std::memory_order_relaxed);
+        }
+        _cv.notify_all();
+    }
+
+    /** Announce that the calling thread is about to wait.
+     *
+     *  @return the key to pass to "wait"/"waitUntil".
+     */
+    uint64_t prepareWait() {
+        _sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Order the announcement before checking the condition.
+        return _epoch.load(std::memory_order_relaxed);
+    }
+
+    /** Withdraw the announcement of "prepareWait" without waiting.
+     */
+    void cancelWait() {
+        _sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /** Block until "notify" is called after "prepareWait" returned key.
+     *
+     *  @arg key - the value returned by "prepareWait".
+     */
+    void wait(uint64_t key) {
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            _cv.wait(locker, [this, key]() { return _epoch.load(std::memory_order_relaxed) != key; });
+        }
+        _sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /** Block until "notify" is called after "prepareWait" returned key, or the deadline passes.
+     *
+     *  @arg key - the value returned by "prepareWait".
+     *  @arg deadline - the time after which to stop waiting.
+     *
+     *  @return true if notified, false if the deadline passed.
+     */
+    template<typename ClockT, typename DurationT>
+    bool waitUntil(uint64_t key, const std::chrono::time_point<ClockT, DurationT>& deadline) {
+        bool notified{};
+        {
+            std::unique_lock<std::mutex> locker(_mu);
+            notified = _cv.wait_until(locker, deadline,
+                                      [this, key]() { return _epoch.load(std::memory_order_relaxed) != key; });
+        }
+        _sleepers.fetch_sub(1, std::memory_order_relaxed);
+        return notified;
+    }
+
+private:
+    std::atomic<uint64_t> _epoch{ 0 }; // incremented by every notification that had sleepers
+    std::atomic<uint32_t> _sleepers{ 0 }; // count threads between prepareWait and the end of the wait
+    std::mutex _mu;
+    std::condition_variable _cv;
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <QueueNotifier.h>
+#include <QueueStatus.h>
+
+/** A set of queues a single consumer thread can wait on.
+ *
+ *  The purpose of the "QueueSet" is to let one consumer serve several
+ *  queues without spinning over each of them. Every queue added to the set
+ *  notifies a shared QueueSignal when data is pushed, so the consumer can
+ *  sleep until any of the queues becomes non-empty.
+ *
+ *  Data is poped in a weighted round-robin order: a queue with weight w
+ *  gives up to w items before the next queue is served.
+ *
+ *  A QueueSet must only be used by one consumer thread, and a queue can
+ *  only belong to one QueueSet at a time.
+ */
+template<typename QueueT>
+class QueueSet {
+
+    using QueueItemT = typename QueueT::ItemType;
+
+public:
+
+    QueueSet() = default;
+
+    ~QueueSet() {
+        for (auto& entry : _queues) {
+            entry.queue->setNotifier(nullptr);
+        }
+    }
+
+    // Make the set non copyable.
+    QueueSet(const QueueSet&) = delete;
+    QueueSet& operator=(const QueueSet&) = delete;
+
+    /** Add a queue to the set.
+     *
+     *  @arg queue - the queue to watch, it must outlive the set.
+     *  @arg weight - the number of items poped from the queue before moving to the next one.
+     */
+    void add(QueueT& queue, size_t weight = 1) {
+        queue.setNotifier(&_signal);
+        _queues.push_back(Entry{ &queue, weight == 0 ? 1 : weight });
+    }
+
+    /** Pop data from the next queue that has some.
+     *
+     *  If no queue has data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if data was poped, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        for (size_t attempt = 0; attempt < _queues.size(); ++attempt) {
+
+            Entry& entry = _queues.at(_current);
+
+            if (entry.queue->pop(popedData)) {
+
+                if (++_served >= entry.weight) {
+                    advance(); // The queue used up its share.
+                }
+
+                return true;
+            }
+
+            advance(); // The queue is empty, move on to the next one.
+        }
+
+        return false;
+    }
+
+    /** Pop data from the next queue that has some, waiting until one does.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return Success if data was poped, Closed if every queue of the set
+     *          is closed and has no more data, or if the set is empty.
+     */
+    QueueStatus select(QueueItemT& popedData) {
+
+        while (!pop(popedData)) {
+
+            uint64_t key = _signal.prepareWait();
+
+            if (pop(popedData)) { // Data might have been pushed before we announced the wait.
+                _signal.cancelWait();
+                return QueueStatus::Success;
+            }
+
+            if (allClosed()) { // Nobody will notify us any more.
+                _signal.cancelWait();
+
+                if (!hasData()) {
+                    return QueueStatus::Closed;
+                }
+
+                std::this_thread::yield(); // A claimed push is still being copied.
+                continue;
+            }
+
+            _signal.wait(key);
+        }
+
+        return QueueStatus::Success;
+    }
+
+    /** Pop data from the next queue that has some, waiting until one does or the deadline passes.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *  @arg deadline - the time after which to stop waiting.
+     *
+     *  @return Success if data was poped, Closed if every queue of the set
+     *          is closed and has no more data, or if the set is empty,
+     *          Timeout if the deadline passed.
+     */
+    template<typename ClockT, typename DurationT>
+    QueueStatus selectUntil(QueueItemT& popedData, const std::chrono::time_point<ClockT, DurationT>& deadline) {
+
+        while (!pop(popedData)) {
+
+            uint64_t key = _signal.prepareWait();
+
+            if (pop(popedData)) { // Data might have been pushed before we announced the wait.
+                _signal.cancelWait();
+                return QueueStatus::Success;
+            }
+
+            if (allClosed()) { // Nobody will notify us any more.
+                _signal.cancelWait();
+
+                if (!hasData()) {
+                    return QueueStatus::Closed;
+                }
+
+                std::this_thread::yield(); // A claimed push is still being copied.
+                continue;
+            }
+
+            if (!_signal.waitUntil(key, deadline)) {
+                return pop(popedData) ? QueueStatus::Success : // Last chance, the deadline passed.
+                                        QueueStatus::Timeout;
+            }
+        }
+
+        return QueueStatus::Success;
+    }
+
+private:
+    struct Entry {
+        QueueT* queue;
+        size_t weight;
+    };
+
+    /** Check if every queue of the set is closed.
+     *
+     *  An empty set counts as closed, no data can ever reach it.
+     *
+     *  @return true if no more data can be pushed into the set.
+     */
+    bool allClosed() {
+        for (auto& entry : _queues) {
+            if (!entry.queue->isClosed()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Check if any queue of the set has data.
+     *
+     *  @return true if there is data in any queue, false otherwise.
+     */
+    bool hasData() {
+        for (auto& entry : _queues) {
+            if (entry.queue->hasData()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Move on to the next queue of the set.
+     */
+    void advance() {
+        _served = 0;
+        _current = (_current + 1) % _queues.size();
+    }
+
+    std::vector<Entry> _queues{}; // the queues of the set
+    size_t _current{ 0 }; // the queue currently served
+    size_t _served{ 0 }; // items poped from the current queue
+    QueueSignal _signal{}; // notified when any queue of the set gets data
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+/** The outcome of a queue operation that can wait.
+ */
+enum class QueueStatus {
+    Success, // the operation completed
+    Timeout, // the deadline passed before the operation could complete
+    Closed,  // the queue is closed (and, for a pop, drained)
+    Full,    // the queue had no space and the data was not pushed
+    Dropped  // the data was discarded by the overflow policy
+};
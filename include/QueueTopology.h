@@ -0,0 +1,42 @@
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+/** The number of threads allowed to push into a queue.
+ *
+ *  eg. LockFreeQueue<Message, 1024, Producers::Single, Consumers::Multi>
+ */
+namespace Producers {
+    struct Single {}; // only one thread pushes at a time
+    struct Multi {};  // any number of threads push concurrently
+}
+
+/** The number of threads allowed to pop from a queue.
+ */
+namespace Consumers {
+    struct Single {}; // only one thread pops at a time
+    struct Multi {};  // any number of threads pop concurrently
+}
+
+template<typename PolicyT>
+concept ProducerPolicy = std::same_as<PolicyT, Producers::Single> || std::same_as<PolicyT, Producers::Multi>;
+
+template<typename PolicyT>
+concept ConsumerPolicy = std::same_as<PolicyT, Consumers::Single> || std::same_as<PolicyT, Consumers::Multi>;
+
+/** The operations a queue algorithm provides to the LockFreeQueue front-end.
+ *
+ *  push and pop never wait, close makes every later push fail while the
+ *  data already in the queue can still be poped.
+ */
+template<typename EngineT>
+concept QueueEngine = requires(EngineT& engine, typename EngineT::ItemType item) {
+    { engine.push(std::move(item)) } -> std::same_as<bool>;
+    { engine.pop(item) } -> std::same_as<bool>;
+    { engine.hasData() } -> std::same_as<bool>;
+    { engine.hasSpace() } -> std::same_as<bool>;
+    { engine.close() };
+    { engine.isClosed() } -> std::same_as<bool>;
+};
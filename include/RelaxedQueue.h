@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <SpmcQueue.h>
+
+/** A multi-producer/multi-consumer queue which only keeps the order of each producer.
+ *
+ *  The purpose of the "RelaxedQueue" is to remove the shared head and tail
+ *  of LockFreeQueue for consumers which do not need a strict FIFO order
+ *  across producers. Every producer owns a sub-ring (an SpmcQueue) and
+ *  pushes without touching any index another producer writes. Consumer c
+ *  pops from sub-ring c % numberOfProducers first, and only moves on to
+ *  the next sub-rings when it is empty, so consumers spread over the
+ *  sub-rings instead of meeting on one head.
+ *
+ *  Ordering:
+ *  - the data of one producer is poped in the order it was pushed.
+ *  - across producers the queue is k-relaxed, with k = (numberOfProducers - 1) * bufferSize:
+ *    a pop returns the oldest data of one sub-ring, so at most the data
+ *    held by the other sub-rings, bufferSize each, was pushed before it
+ *    and is still in the queue.
+ *
+ *  The number of producers is fixed on construction. Producer i must only
+ *  be served by one thread at a time, while any number of threads may pop.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class RelaxedQueue {
+public:
+
+    using ItemType = QueueItemT;
+
+    RelaxedQueue() = delete;
+
+    /** A constructor which takes the number of producers as argument.
+     *
+     *  @arg numberOfProducers - the number of producers, identified as 0 to numberOfProducers-1.
+     */
+    explicit RelaxedQueue(size_t numberOfProducers)
+    : _numberOfProducers{ numberOfProducers == 0 ? 1 : numberOfProducers },
+      _rings{ std::make_unique<SpmcQueue<QueueItemT, bufferSize>[]>(_numberOfProducers) }
+    {}
+
+    ~RelaxedQueue() = default;
+
+    // Make the queue non copyable.
+    RelaxedQueue(const RelaxedQueue&) = delete;
+    RelaxedQueue& operator=(const RelaxedQueue&) = delete;
+
+    /** Push data into the sub-ring of a producer.
+     *
+     *  If the sub-ring has no space, the thread will return false and will
+     *  not wait for space to become available, even if other sub-rings have some.
+     *
+     *  @arg producer - the producer pushing the data.
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(size_t producer, QueueItemT bufferItem) {
+        return _rings[producer].push(std::move(bufferItem));
+    }
+
+    /** Pop data from the queue, starting with the sub-ring of a consumer.
+     *
+     *  If no sub-ring has data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg consumer - any number identifying the consumer, used to pick its first sub-ring.
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(size_t consumer, QueueItemT& popedData) {
+
+        size_t first{ consumer % _numberOfProducers };
+
+        for (size_t i = 0; i < _numberOfProducers; ++i) {
+            if (_rings[(first + i) % _numberOfProducers].pop(popedData)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if any sub-ring has data, false otherwise.
+     */
+    bool hasData() {
+        for (size_t i = 0; i < _numberOfProducers; ++i) {
+            if (_rings[i].hasData()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** The most data pushed before a poped item that can still be in the queue.
+     */
+    size_t relaxation() const {
+        return (_numberOfProducers - 1) * bufferSize;
+    }
+
+private:
+    size_t _numberOfProducers{ 0 };
+    std::unique_ptr<SpmcQueue<QueueItemT, bufferSize>[]> _rings; // one sub-ring per producer
+};
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <Sequence.h>
+
+/** A ring of indexes driven by fetch-and-add tickets (the SCQ design of Nikolaev).
+ *
+ *  The purpose of the "ScqRing" is to hand out the indexes 0..capacity-1
+ *  in FIFO order without a compare-and-swap retry loop on a shared
+ *  counter: every enqueue and dequeue takes a ticket from its cursor with
+ *  one fetch_add and, in the common case, settles its entry with one more
+ *  atomic on an entry no other thread is aiming at.
+ *
+ *  The ring has twice as many entries as indexes, and each entry holds
+ *  the cycle (the ticket divided by the ring size) it was last written
+ *  in, a safe bit and an index (all ones when the entry is empty). A
+ *  dequeuer which overtakes an enqueuer marks the entry with its own
+ *  cycle, so the late enqueuer takes another ticket instead of writing
+ *  behind it. The threshold counts how many more failed dequeues may
+ *  happen before the ring is surely empty, which keeps dequeuers from
+ *  running the head arbitrarily far past the tail.
+ *
+ *  The cycles are not compared modulo wrap-around: with 64-bit tickets
+ *  and entries they would take centuries to overflow.
+ */
+template<size_t capacity>
+class ScqRing {
+
+    static_assert(capacity >= 2 && std::has_single_bit(capacity), "The capacity must be a power of two.");
+
+    static constexpr size_t ringSize{ 2 * capacity }; // the number of entries
+    static constexpr size_t ringBits{ static_cast<size_t>(std::countr_zero(ringSize)) };
+    static constexpr uint64_t emptyIndex{ ringSize - 1 }; // an entry without an index, distinct from any index
+    static constexpr uint64_t safeBit{ uint64_t{ 1 } << ringBits };
+    static constexpr size_t cycleShift{ ringBits + 1 };
+    static constexpr long long fullThreshold{ 3 * static_cast<long long>(capacity) - 1 };
+    static constexpr size_t dequeueSpins{ 64 }; // how long a dequeuer waits for the enqueuer it overtook
+
+public:
+
+    static constexpr size_t noIndex{ static_cast<size_t>(-1) };
+
+    /** Build an empty ring, or a full one holding 0..capacity-1 in order.
+     *
+     *  @arg full - true to start with every index in the ring.
+     */
+    explicit ScqRing(bool full) {
+
+        _head.value.store(ringSize, std::memory_order_relaxed); // Start at cycle 1, the entries are in cycle 0.
+        _tail.value.store(full ? ringSize + capacity : ringSize, std::memory_order_relaxed);
+        _threshold.store(full ? fullThreshold : -1, std::memory_order_relaxed);
+
+        for (size_t position = 0; position < ringSize; ++position) {
+            _entries[remap(position)].store(full && position < capacity ? entry(1, safeBit, position) : entry(0, safeBit, emptyIndex),
+                                            std::memory_order_relaxed);
+        }
+    }
+
+    // Make the ring non copyable.
+    ScqRing(const ScqRing&) = delete;
+    ScqRing& operator=(const ScqRing&) = delete;
+
+    /** Add an index.
+     *
+     *  There are never more than capacity indexes in the ring, so this
+     *  always succeeds.
+     *
+     *  @arg index - the index, below capacity.
+     */
+    void enqueue(size_t index) {
+
+        while (true) {
+
+            size_t tail = _tail.value.fetch_add(1, std::memory_order_seq_cst);
+            uint64_t tailCycle = tail / ringSize;
+
+            std::atomic<uint64_t>& slot = _entries[remap(tail)];
+            uint64_t current = slot.load(std::memory_order_acquire);
+
+            while (cycleOf(current) < tailCycle && indexOf(current) == emptyIndex &&
+                   ((current & safeBit) != 0 || _head.value.load(std::memory_order_seq_cst) <= tail)) {
+
+                if (slot.compare_exchange_weak(current, entry(tailCycle, safeBit, index),
+                                               std::memory_order_acq_rel, std::memory_order_acquire)) {
+
+                    if (_threshold.load(std::memory_order_relaxed) != fullThreshold) {
+                        _threshold.store(fullThreshold, std::memory_order_seq_cst);
+                    }
+                    return;
+                }
+            }
+            // The entry is taken, or a dequeuer already went past it: take another ticket.
+        }
+    }
+
+    /** Remove the oldest index.
+     *
+     *  @return the index, or noIndex if the ring is empty.
+     */
+    size_t dequeue() {
+
+        if (_threshold.load(std::memory_order_seq_cst) < 0) {
+            return noIndex; // Surely empty, do not even take a ticket.
+        }
+
+        while (true) {
+
+            size_t head = _head.value.fetch_add(1, std::memory_order_seq_cst);
+            uint64_t headCycle = head / ringSize;
+
+            std::atomic<uint64_t>& slot = _entries[remap(head)];
+
+            size_t spins{ 0 };
+            uint64_t current = slot.load(std::memory_order_acquire);
+
+            while (true) {
+
+                uint64_t currentCycle = cycleOf(current);
+
+                if (currentCycle == headCycle) {
+                    slot.fetch_or(emptyIndex, std::memory_order_acq_rel); // Consume it, keeping the cycle and the safe bit.
+                    return static_cast<size_t>(indexOf(current));
+                }
+
+                if (currentCycle > headCycle) {
+                    break; // A newer cycle already owns the entry.
+                }
+
+                uint64_t replacement{};
+
+                if (indexOf(current) != emptyIndex) {
+                    replacement = current & ~safeBit; // An index of an older cycle: make its enqueuers' successors skip it.
+                    if (replacement == current) {
+                        break;
+                    }
+                }
+                else {
+                    if (++spins <= dequeueSpins) { // Our enqueuer may be about to write, give it a moment.
+                        current = slot.load(std::memory_order_acquire);
+                        continue;
+                    }
+                    replacement = entry(headCycle, current & safeBit, emptyIndex); // Close the entry for this cycle.
+                }
+
+                if (slot.compare_exchange_weak(current, replacement, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    break;
+                }
+            }
+
+            size_t tail = _tail.value.load(std::memory_order_seq_cst);
+
+            if (tail <= head + 1) {
+                catchUp(tail, head + 1);
+                _threshold.fetch_sub(1, std::memory_order_seq_cst);
+                return noIndex;
+            }
+
+            if (_threshold.fetch_sub(1, std::memory_order_seq_cst) <= 0) {
+                return noIndex;
+            }
+        }
+    }
+
+    /** Check if the ring looks non empty, a snapshot which may be stale by the time it returns.
+     *
+     * @return true if there seems to be an index in the ring, false otherwise.
+     */
+    bool hasIndexes() {
+        return _threshold.load(std::memory_order_seq_cst) >= 0 &&
+               _tail.value.load(std::memory_order_seq_cst) > _head.value.load(std::memory_order_seq_cst);
+    }
+
+private:
+
+    static constexpr uint64_t entry(uint64_t cycle, uint64_t safe, uint64_t index) {
+        return (cycle << cycleShift) | safe | index;
+    }
+
+    static constexpr uint64_t cycleOf(uint64_t value) {
+        return value >> cycleShift;
+    }
+
+    static constexpr uint64_t indexOf(uint64_t value) {
+        return value & emptyIndex;
+    }
+
+    /** Spread consecutive tickets over different cache lines, so neighbouring tickets do not share one.
+     *
+     *  @arg position - the ticket.
+     *
+     *  @return the entry of the ticket.
+     */
+    static constexpr size_t remap(size_t position) {
+
+        constexpr size_t lineBits{ static_cast<size_t>(std::countr_zero(cacheLineSize / sizeof(uint64_t))) };
+
+        position &= ringSize - 1;
+
+        if constexpr (ringBits <= lineBits) {
+            return position; // The whole ring fits in a cache line.
+        }
+        else {
+            return (position >> (ringBits - lineBits)) | ((position << lineBits) & (ringSize - 1)); // Rotate the bits.
+        }
+    }
+
+    /** Move the tail up to the head after dequeuers overshot it, so enqueuers do not waste tickets behind the head.
+     *
+     *  @arg tail - the tail seen.
+     *  @arg head - the head to move it to.
+     */
+    void catchUp(size_t tail, size_t head) {
+        while (!_tail.value.compare_exchange_weak(tail, head, std::memory_order_seq_cst, std::memory_order_seq_cst)) {
+            head = _head.value.load(std::memory_order_seq_cst);
+            tail = _tail.value.load(std::memory_order_seq_cst);
+            if (tail >= head) {
+                break;
+            }
+        }
+    }
+
+    Sequence _head{}; // the next dequeue ticket
+    Sequence _tail{}; // the next enqueue ticket
+    alignas(cacheLineSize) std::atomic<long long> _threshold{ -1 }; // failed dequeues left before the ring is surely empty
+    alignas(cacheLineSize) std::array<std::atomic<uint64_t>, ringSize> _entries{}; // cycle | safe | index
+};
+
+/** A multi-producer/multi-consumer queue built from fetch-and-add tickets.
+ *
+ *  The purpose of the "ScqQueue" is to keep scaling where the _canUpdate
+ *  handshake of MpmcQueue does not: with many threads, most attempts to
+ *  enter the critical section fail and only move its cache line around,
+ *  while here every push and pop makes progress with one fetch_add in the
+ *  common case.
+ *
+ *  It is the SCQ design: a ring of free spaces and a ring of full spaces.
+ *  A push takes a space from the free ring, copies the data in and adds
+ *  the space to the full ring; a pop does the reverse. Unlike MpmcQueue
+ *  every space can be used, and bufferSize must be a power of two.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class ScqQueue {
+public:
+
+    using ItemType = QueueItemT;
+
+    ScqQueue() = default;
+    ~ScqQueue() = default;
+
+    // Make the queue non copyable.
+    ScqQueue(const ScqQueue&) = delete;
+    ScqQueue& operator=(const ScqQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        if (_closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        size_t index = _free.dequeue();
+
+        if (index == ScqRing<bufferSize>::noIndex) {
+            return false;
+        }
+
+        _buffer[index] = std::move(bufferItem);
+        _full.enqueue(index); // Publish the data.
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        size_t index = _full.dequeue();
+
+        if (index == ScqRing<bufferSize>::noIndex) {
+            return false;
+        }
+
+        popedData = std::move(_buffer[index]);
+        _free.enqueue(index); // Hand the space back to the producers.
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _full.hasIndexes();
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true if there is space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return _free.hasIndexes();
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push which starts fails, while the data
+     *  already in the queue can still be poped.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+private:
+    ScqRing<bufferSize> _free{ true }; // the spaces producers may fill
+    ScqRing<bufferSize> _full{ false }; // the spaces holding data, in push order
+    alignas(cacheLineSize) std::atomic_bool _closed{ false }; // set once the queue is closed
+    std::array<QueueItemT, bufferSize> _buffer{}; // the data, indexed by the rings
+};
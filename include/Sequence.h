@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/** The size of a cache line, used to keep independently written indexes apart.
+ */
+inline constexpr size_t cacheLineSize{ 64 };
+
+/** A sequence number on its own cache line.
+ *
+ *  The purpose of the "Sequence" is to hold a monotonically increasing
+ *  position (eg. a producer or consumer cursor) without false sharing with
+ *  the positions written by other threads.
+ */
+struct alignas(cacheLineSize) Sequence {
+    std::atomic<size_t> value{ 0 };
+};
+
+/** Swap the values of two atomics no other thread is using.
+ *
+ *  @arg first - the first atomic.
+ *  @arg second - the second atomic.
+ */
+template<typename ValueT>
+void swapQuiescent(std::atomic<ValueT>& first, std::atomic<ValueT>& second) {
+    ValueT value = first.load(std::memory_order_relaxed);
+    first.store(second.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    second.store(value, std::memory_order_relaxed);
+}
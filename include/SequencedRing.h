@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <Sequence.h>
+
+/** A single-producer ring processed in place by a graph of consumer stages.
+ *
+ *  The purpose of the "SequencedRing" is to run a pipeline (eg. decode,
+ *  enrich, publish) over one buffer instead of handing the data from queue
+ *  to queue. Every stage declares the stages it depends on, and only
+ *  processes a space once all of them have released it. The producer only
+ *  reuses a space once every stage has released it.
+ *
+ *  Stages are added before the producer and stages start running. Each
+ *  stage must only be processed by one thread at a time, and only one
+ *  thread may publish.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class SequencedRing {
+public:
+
+    using ItemType = QueueItemT;
+    using StageId = size_t;
+
+    SequencedRing() = default;
+    ~SequencedRing() = default;
+
+    // Make the ring non copyable.
+    SequencedRing(const SequencedRing&) = delete;
+    SequencedRing& operator=(const SequencedRing&) = delete;
+
+    /** Add a consumer stage.
+     *
+     *  A stage without dependencies processes the data as soon as it is
+     *  published.
+     *
+     *  @arg dependencies - the stages which must release a space before this stage processes it.
+     *
+     *  @return the id of the new stage.
+     */
+    StageId addStage(std::initializer_list<StageId> dependencies = {}) {
+
+        auto stage = std::make_unique<Stage>();
+
+        for (StageId dependency : dependencies) {
+            _stages.at(dependency)->isDependency = true; // Stages can only depend on existing ones, so there can be no cycle.
+            stage->dependencies.push_back(dependency);
+        }
+
+        _stages.push_back(std::move(stage));
+
+        return _stages.size() - 1;
+    }
+
+    /** Publish data by filling the next space in place.
+     *
+     *  If the last stages have not released the next space, the thread will
+     *  return false and will not wait for it.
+     *
+     *  @arg fill - called with the space to fill.
+     */
+    template<typename FillT>
+    bool publish(FillT&& fill) {
+
+        if (_next - _gatingCache >= bufferSize) { // Only look at the stages when the cached position says we are full.
+
+            _gatingCache = slowestLastStage();
+
+            if (_next - _gatingCache >= bufferSize) {
+                return false;
+            }
+        }
+
+        fill(_buffer[_next % bufferSize]);
+
+        ++_next;
+        _published.value.store(_next, std::memory_order_release); // Make the data visible to the stages.
+
+        return true;
+    }
+
+    /** Push data into the ring.
+     *
+     *  @arg bufferItem - the data to be pushed into the ring.
+     */
+    bool push(QueueItemT bufferItem) {
+        return publish([&bufferItem](QueueItemT& space) { space = std::move(bufferItem); });
+    }
+
+    /** Process the data a stage is allowed to see.
+     *
+     *  The purpose of the "process" function is to run a stage over up to
+     *  maxBatch spaces, in place, and then release them to the stages which
+     *  depend on it (or to the producer) in one store.
+     *
+     *  @arg stage - the stage to run.
+     *  @arg handler - called with every space to process.
+     *  @arg maxBatch - the maximum number of spaces to process.
+     *
+     *  @return the number of spaces processed.
+     */
+    template<typename HandlerT>
+    size_t process(StageId stage, HandlerT&& handler, size_t maxBatch = bufferSize) {
+
+        Stage& current = *_stages[stage];
+        size_t position = current.cursor.value.load(std::memory_order_relaxed);
+
+        if (position == current.availableCache) { // Only look at the dependencies when the cached position says we are done.
+
+            current.availableCache = available(current);
+
+            if (position == current.availableCache) {
+                return 0;
+            }
+        }
+
+        size_t end = current.availableCache - position > maxBatch ?
+                        position + maxBatch :
+                        current.availableCache;
+
+        for (size_t sequence = position; sequence < end; ++sequence) {
+            handler(_buffer[sequence % bufferSize]);
+        }
+
+        current.cursor.value.store(end, std::memory_order_release); // Release the spaces.
+
+        return end - position;
+    }
+
+    /** Check if a stage has spaces to process.
+     *
+     *  @arg stage - the stage to check for.
+     *
+     *  @return true if there is data for the stage, false otherwise.
+     */
+    bool hasData(StageId stage) {
+        Stage& current = *_stages[stage];
+        return current.cursor.value.load(std::memory_order_relaxed) != available(current);
+    }
+
+private:
+    struct Stage {
+        Sequence cursor{}; // the next sequence the stage processes
+        size_t availableCache{ 0 }; // the last position the stage was allowed to reach
+        std::vector<StageId> dependencies{}; // the stages which must process a space first
+        bool isDependency{ false }; // true if another stage depends on this one
+    };
+
+    /** Find how far a stage is allowed to go.
+     *
+     *  @arg stage - the stage to check for.
+     *
+     *  @return the smallest position of its dependencies, or the published position.
+     */
+    size_t available(Stage& stage) {
+        size_t limit = _published.value.load(std::memory_order_acquire);
+        for (StageId dependency : stage.dependencies) {
+            size_t position = _stages[dependency]->cursor.value.load(std::memory_order_acquire);
+            if (position < limit) {
+                limit = position;
+            }
+        }
+        return limit;
+    }
+
+    /** Find the position of the slowest stage nobody depends on.
+     *
+     *  @return the smallest position of the last stages.
+     */
+    size_t slowestLastStage() {
+        size_t slowest{ _next };
+        for (auto& stage : _stages) {
+            if (!stage->isDependency) {
+                size_t position = stage->cursor.value.load(std::memory_order_acquire);
+                if (position < slowest) {
+                    slowest = position;
+                }
+            }
+        }
+        return slowest;
+    }
+
+    std::array<QueueItemT, bufferSize> _buffer{}; // the ring buffer
+    Sequence _published{}; // the number of items published by the producer
+
+    alignas(cacheLineSize) size_t _next{ 0 }; // the next sequence the producer writes (producer only)
+    size_t _gatingCache{ 0 }; // the last slowest stage position the producer saw (producer only)
+    std::vector<std::unique_ptr<Stage>> _stages{}; // the consumer stages
+};
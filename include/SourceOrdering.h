@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+/** Data stamped with the producer which pushed it and its position in that producer's stream.
+ */
+template<typename ValueT>
+struct SequencedItem {
+    size_t producerId{ 0 }; // the producer which pushed the data
+    uint64_t sequence{ 0 }; // the position of the data in the stream of the producer, starting at 0
+    ValueT value{};
+};
+
+/** Stamps the data of one producer.
+ *
+ *  The purpose of the "SequenceStamper" is to let a producer tag its data
+ *  before pushing it into any queue (eg. a RelaxedQueue or several sharded
+ *  queues), so the consumers can check or restore the order of each source.
+ *
+ *  eg. queue.push(stamper.stamp(value));
+ *
+ *  A stamper must only be used by one thread at a time.
+ */
+class SequenceStamper {
+public:
+    explicit SequenceStamper(size_t producerId) : _producerId{ producerId } {}
+
+    /** Stamp the next data of the producer.
+     *
+     *  @arg value - the data to stamp.
+     *
+     *  @return the stamped data.
+     */
+    template<typename ValueT>
+    SequencedItem<ValueT> stamp(ValueT value) {
+        return SequencedItem<ValueT>{ _producerId, _next++, std::move(value) };
+    }
+
+private:
+    size_t _producerId; // the producer the stamps belong to
+    uint64_t _next{ 0 }; // the sequence of the next stamp
+};
+
+/** What an OrderingChecker expects from the stream of each producer.
+ */
+enum class OrderingCheck {
+    Monotonic,  // every sequence is larger than the previous one, gaps are allowed (one of several consumers)
+    Contiguous  // every sequence is the previous one + 1 (the only consumer)
+};
+
+/** Checks the per-producer order of the data seen by one consumer.
+ *
+ *  The purpose of the "OrderingChecker" is to verify, in tests or in a
+ *  debug build, the ordering invariants a relaxed or sharded queue layout
+ *  still promises. Violations are counted rather than thrown, so the
+ *  checker can stay enabled while the consumer keeps running.
+ *
+ *  A checker must only be used by one thread at a time.
+ */
+class OrderingChecker {
+public:
+    explicit OrderingChecker(OrderingCheck mode = OrderingCheck::Monotonic) : _mode{ mode } {}
+
+    /** Check the next data seen by the consumer.
+     *
+     *  @arg producerId - the producer which pushed the data.
+     *  @arg sequence - the sequence of the data.
+     *
+     *  @return true if the data is in order, false otherwise.
+     */
+    bool check(size_t producerId, uint64_t sequence) {
+
+        if (producerId >= _expected.size()) {
+            _expected.resize(producerId + 1, 0);
+        }
+
+        uint64_t& expected = _expected[producerId];
+
+        bool inOrder = _mode == OrderingCheck::Contiguous ?
+                            sequence == expected :
+                            sequence >= expected;
+
+        if (!inOrder) {
+            ++_violations;
+        }
+
+        if (sequence >= expected) {
+            expected = sequence + 1;
+        }
+
+        return inOrder;
+    }
+
+    /** Check the next stamped data seen by the consumer.
+     *
+     *  @arg item - the stamped data.
+     *
+     *  @return true if the data is in order, false otherwise.
+     */
+    template<typename ValueT>
+    bool check(const SequencedItem<ValueT>& item) {
+        return check(item.producerId, item.sequence);
+    }
+
+    /** The number of data seen out of order.
+     */
+    size_t violations() const {
+        return _violations;
+    }
+
+private:
+    OrderingCheck _mode; // what the checker expects
+    std::vector<uint64_t> _expected{}; // the smallest acceptable next sequence of each producer
+    size_t _violations{ 0 }; // the number of data seen out of order
+};
+
+/** Puts the data of each producer back in order.
+ *
+ *  The purpose of the "ReorderBuffer" is to let a consumer adopt a layout
+ *  which does not keep the order of a source (eg. several consumers of a
+ *  RelaxedQueue forwarding to one sink, or several sharded queues) and
+ *  still hand the data of each producer on in sequence. Data which comes
+ *  early is held until the data before it arrives.
+ *
+ *  A reorder buffer must only be used by one thread at a time.
+ */
+template<typename ValueT>
+class ReorderBuffer {
+public:
+
+    ReorderBuffer() = default;
+
+    /** Add stamped data.
+     *
+     *  Data older than what was already released is dropped.
+     *
+     *  @arg item - the stamped data.
+     *
+     *  @return true if the data was added, false if it was dropped.
+     */
+    bool insert(SequencedItem<ValueT> item) {
+
+        if (item.producerId >= _sources.size()) {
+            _sources.resize(item.producerId + 1);
+        }
+
+        Source& source = _sources[item.producerId];
+
+        if (item.sequence < source.next || !source.held.emplace(item.sequence, std::move(item.value)).second) {
+            return false; // Already released, or a duplicate.
+        }
+
+        ++_held;
+
+        return true;
+    }
+
+    /** Hand on every data whose predecessors have all been handed on.
+     *
+     *  @arg handler - called with every released data, in the order of its producer.
+     *
+     *  @return the number of data released.
+     */
+    template<typename HandlerT>
+    size_t release(HandlerT&& handler) {
+
+        size_t released{ 0 };
+
+        for (size_t producerId = 0; producerId < _sources.size(); ++producerId) {
+
+            Source& source = _sources[producerId];
+
+            auto next = source.held.begin();
+            while (next != source.held.end() && next->first == source.next) {
+                handler(SequencedItem<ValueT>{ producerId, next->first, std::move(next->second) });
+                next = source.held.erase(next);
+                ++source.next;
+                ++released;
+            }
+        }
+
+        _held -= released;
+
+        return released;
+    }
+
+    /** The number of data waiting for their predecessors.
+     */
+    size_t held() const {
+        return _held;
+    }
+
+private:
+    struct Source {
+        uint64_t next{ 0 }; // the sequence to release next
+        std::map<uint64_t, ValueT> held{}; // the data which came early, by sequence
+    };
+
+    std::vector<Source> _sources{}; // the state of each producer
+    size_t _held{ 0 }; // the number of data held
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include <Sequence.h>
+
+/** A single-producer/multi-consumer queue.
+ *
+ *  The purpose of the "SpmcQueue" is to serve the one-to-many topology of
+ *  a dispatcher feeding a pool of workers. The producer publishes with a
+ *  plain release store (no read-modify-write and no critical section) and
+ *  the consumers claim data with a compare-and-swap on the head.
+ *
+ *  Every space carries a sequence number telling whose turn it is:
+ *  sequence == n means the space is free for ticket n, sequence == n + 1
+ *  means it holds the data of ticket n.
+ *
+ *  Only one thread may push.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class SpmcQueue {
+public:
+
+    using ItemType = QueueItemT;
+
+    SpmcQueue() {
+        for (size_t i = 0; i < bufferSize; ++i) {
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~SpmcQueue() = default;
+
+    // Make the queue non copyable.
+    SpmcQueue(const SpmcQueue&) = delete;
+    SpmcQueue& operator=(const SpmcQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return false and will not
+     *  wait for space to become available.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        if (_closed.load(std::memory_order_relaxed)) {
+            return false; // Only the producer closes the queue, so there is no race.
+        }
+
+        size_t tail = _tail.value.load(std::memory_order_relaxed); // Only the producer writes the tail.
+        Slot& slot = _buffer[tail % bufferSize];
+
+        if (slot.sequence.load(std::memory_order_acquire) != tail) {
+            return false; // A consumer has not finished with the space yet.
+        }
+
+        slot.item = std::move(bufferItem);
+        slot.sequence.store(tail + 1, std::memory_order_release); // Publish the data.
+
+        _tail.value.store(tail + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        size_t head = _head.value.load(std::memory_order_relaxed);
+        Slot* slot{ nullptr };
+
+        while (true) {
+
+            slot = &_buffer[head % bufferSize];
+            auto lag = static_cast<std::ptrdiff_t>(
+                           slot->sequence.load(std::memory_order_acquire) - (head + 1));
+
+            if (lag < 0) {
+                return false; // The producer has not published this ticket yet.
+            }
+
+            if (lag > 0) {
+                head = _head.value.load(std::memory_order_relaxed); // Another consumer took it, look again.
+                continue;
+            }
+
+            if (_head.value.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                break; // We claimed the ticket.
+            }
+        }
+
+        popedData = std::move(slot->item);
+        slot->sequence.store(head + bufferSize, std::memory_order_release); // Hand the space to the next lap.
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _tail.value.load(std::memory_order_acquire) != _head.value.load(std::memory_order_acquire);
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true if there is space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return _tail.value.load(std::memory_order_acquire) - _head.value.load(std::memory_order_acquire) < bufferSize;
+    }
+
+    /** Count the free spaces of the queue.
+     *
+     * @return the number of items the queue has room for.
+     */
+    size_t freeSpace() {
+        size_t head = _head.value.load(std::memory_order_acquire);
+        size_t used = _tail.value.load(std::memory_order_acquire) - head;
+        return used < bufferSize ? bufferSize - used : 0; // The head may have moved on since it was read.
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped. It must be called by the producer thread,
+     *  or once the producer has stopped pushing.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+    /** Swap the data of two queues.
+     *
+     *  Both queues must be quiescent: no thread may use either of them
+     *  until the function returns. The closed state stays with each queue.
+     *
+     *  @arg other - the queue to swap the data with.
+     */
+    void swapContents(SpmcQueue& other) {
+
+        for (size_t i = 0; i < bufferSize; ++i) {
+            swapQuiescent(_buffer[i].sequence, other._buffer[i].sequence);
+            std::swap(_buffer[i].item, other._buffer[i].item);
+        }
+
+        swapQuiescent(_tail.value, other._tail.value);
+        swapQuiescent(_head.value, other._head.value);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Publish the swap to whoever uses the queues next.
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 }; // whose turn it is to use the space
+        QueueItemT item{};
+    };
+
+    Sequence _tail{}; // the next ticket written by the producer
+    Sequence _head{}; // the next ticket claimed by a consumer
+    std::atomic_bool _closed{ false }; // set once the queue is closed
+    std::array<Slot, bufferSize> _buffer{}; // the ring buffer
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include <Sequence.h>
+
+/** A single-producer/single-consumer queue.
+ *
+ *  The purpose of the "SpscQueue" is to give a one-to-one pipeline the
+ *  cheapest possible path. Each side owns its index and only publishes it
+ *  with a release store, and keeps a cached copy of the other side's index
+ *  so it only reads the shared cache line when the cached copy says the
+ *  queue is full (producer) or empty (consumer).
+ *
+ *  Only one thread may push and only one thread may pop.
+ */
+template<typename QueueItemT, size_t bufferSize>
+class SpscQueue {
+public:
+
+    using ItemType = QueueItemT;
+
+    SpscQueue() = default;
+    ~SpscQueue() = default;
+
+    // Make the queue non copyable.
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  If there is no space, or the queue is closed, the thread will return
+     *  false and will not wait for space to become available.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        if (_closed.load(std::memory_order_relaxed)) {
+            return false; // Only the producer closes the queue, so there is no race.
+        }
+
+        size_t tail = _tail.value.load(std::memory_order_relaxed);
+
+        if (tail - _headCache >= bufferSize) { // Only look at the consumer when the cached position says we are full.
+
+            _headCache = _head.value.load(std::memory_order_acquire);
+
+            if (tail - _headCache >= bufferSize) {
+                return false;
+            }
+        }
+
+        _buffer[tail % bufferSize] = std::move(bufferItem);
+        _tail.value.store(tail + 1, std::memory_order_release); // Publish the data.
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        size_t head = _head.value.load(std::memory_order_relaxed);
+
+        if (head == _tailCache) { // Only look at the producer when the cached position says we are empty.
+
+            _tailCache = _tail.value.load(std::memory_order_acquire);
+
+            if (head == _tailCache) {
+                return false;
+            }
+        }
+
+        popedData = std::move(_buffer[head % bufferSize]);
+        _head.value.store(head + 1, std::memory_order_release); // Hand the space back to the producer.
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        return _tail.value.load(std::memory_order_acquire) != _head.value.load(std::memory_order_acquire);
+    }
+
+    /** Check if there is space in the queue.
+     *
+     * @return true if there is space in the queue, false otherwise.
+     */
+    bool hasSpace() {
+        return _tail.value.load(std::memory_order_acquire) - _head.value.load(std::memory_order_acquire) < bufferSize;
+    }
+
+    /** Count the free spaces of the queue.
+     *
+     * @return the number of items the queue has room for.
+     */
+    size_t freeSpace() {
+        size_t head = _head.value.load(std::memory_order_acquire);
+        size_t used = _tail.value.load(std::memory_order_acquire) - head;
+        return used < bufferSize ? bufferSize - used : 0; // The head may have moved on since it was read.
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push fails, while the data already in the
+     *  queue can still be poped. It must be called by the producer thread,
+     *  or once the producer has stopped pushing.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+    /** Swap the data of two queues.
+     *
+     *  Both queues must be quiescent: no thread may use either of them
+     *  until the function returns. The closed state stays with each queue.
+     *
+     *  @arg other - the queue to swap the data with.
+     */
+    void swapContents(SpscQueue& other) {
+
+        std::swap(_buffer, other._buffer);
+
+        swapQuiescent(_tail.value, other._tail.value);
+        swapQuiescent(_head.value, other._head.value);
+
+        _headCache = _head.value.load(std::memory_order_relaxed);
+        _tailCache = _tail.value.load(std::memory_order_relaxed);
+        other._headCache = other._head.value.load(std::memory_order_relaxed);
+        other._tailCache = other._tail.value.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Publish the swap to whoever uses the queues next.
+    }
+
+private:
+    Sequence _tail{}; // the next sequence written by the producer
+    Sequence _head{}; // the next sequence read by the consumer
+
+    alignas(cacheLineSize) size_t _headCache{ 0 }; // the last consumer position the producer saw (producer only)
+    std::atomic_bool _closed{ false }; // set once the queue is closed
+
+    alignas(cacheLineSize) size_t _tailCache{ 0 }; // the last producer position the consumer saw (consumer only)
+
+    std::array<QueueItemT, bufferSize> _buffer{}; // the ring buffer
+};
@@ -0,0 +1,473 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <EpochReclamation.h>
+
+/** An unbounded wait-free multi-producer/multi-consumer queue.
+ *
+ *  The purpose of the "WaitFreeQueue" is to guarantee that no push or pop
+ *  is starved, which the retry loops of the other queues cannot: the
+ *  helping of each operation completes in a number of steps bounded by
+ *  the number of threads, whatever the other threads do. It is the queue
+ *  of Kogan and Petrank, a Michael & Scott list where every operation is
+ *  announced with a phase number and every thread helps all the
+ *  operations with a phase up to its own before its own completes.
+ *
+ *  Nodes and announcements are retired to an EpochReclamation domain,
+ *  and the index of a thread's membership in it is the thread's
+ *  announcement slot. Every thread joins on its first use of the queue
+ *  and leaves when it exits, so at most maxThreads threads may have used
+ *  the queue at the same time.
+ *
+ *  The bound counts the loads and compare_exchanges of the announce and
+ *  help loops, not three steps which are not bounded: the allocation of
+ *  a push's node and of the Operation descriptors (by announce, and by
+ *  the helpers when they replace an announcement), the push_back of a
+ *  retired pointer onto the participant's list, and the reclaim() which
+ *  every batchSize retirements frees a batch of any size, including the
+ *  nodes adopted from threads which left.
+ */
+template<typename QueueItemT>
+class WaitFreeQueue {
+
+    static constexpr size_t noThread{ static_cast<size_t>(-1) };
+
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        size_t enqueuer{ noThread }; // the slot of the push which links the node
+        std::atomic<size_t> dequeuer{ noThread }; // the slot of the pop which took the node as its dummy
+        QueueItemT item{};
+    };
+
+    /** The announcement of an operation, never changed once published.
+     */
+    struct Operation {
+        uint64_t phase{ 0 }; // operations with a smaller phase are helped first
+        bool pending{ false }; // false once the operation took effect
+        bool push{ true }; // a push, or a pop
+        Node* node{ nullptr }; // the node to link (push), or the dummy poped past, nullptr if the queue was empty (pop)
+    };
+
+    using Domain = EpochReclamation<>;
+    using Participant = Domain::Participant;
+
+    /** The state the memberships of the threads keep alive after the queue is gone.
+     */
+    struct Shared {
+        explicit Shared(size_t maxThreads)
+        : domain{ maxThreads },
+          announcements{ std::make_unique<std::atomic<Operation*>[]>(maxThreads) },
+          maxThreads{ maxThreads }
+        {
+            for (size_t slot = 0; slot < maxThreads; ++slot) {
+                announcements[slot].store(new Operation{}, std::memory_order_relaxed);
+            }
+        }
+
+        ~Shared() {
+            for (size_t slot = 0; slot < maxThreads; ++slot) {
+                delete announcements[slot].load(std::memory_order_relaxed);
+            }
+        }
+
+        Domain domain; // reclaims the nodes and the replaced announcements
+        std::unique_ptr<std::atomic<Operation*>[]> announcements; // the last operation of each slot
+        size_t maxThreads; // the number of slots
+        std::atomic_bool destroyed{ false }; // set once the queue is gone, so the members can leave
+    };
+
+public:
+
+    using ItemType = QueueItemT;
+
+    /** A constructor which takes the maximum number of threads as argument.
+     *
+     *  @arg maxThreads - the maximum number of threads using the queue at the same time.
+     */
+    explicit WaitFreeQueue(size_t maxThreads = 128)
+    : _shared{ std::make_shared<Shared>(maxThreads) },
+      _id{ nextQueueId().fetch_add(1, std::memory_order_relaxed) }
+    {
+        Node* dummy = new Node{};
+        _head.store(dummy, std::memory_order_relaxed);
+        _tail.store(dummy, std::memory_order_relaxed);
+    }
+
+    /** Free the nodes still in the queue.
+     *
+     *  No thread may use the queue any more.
+     */
+    ~WaitFreeQueue() {
+        _shared->destroyed.store(true, std::memory_order_release);
+
+        Node* node = _head.load(std::memory_order_acquire);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    // Make the queue non copyable.
+    WaitFreeQueue(const WaitFreeQueue&) = delete;
+    WaitFreeQueue& operator=(const WaitFreeQueue&) = delete;
+
+    /** Push data into the queue.
+     *
+     *  The queue grows as needed, so the data is pushed unless the queue
+     *  is closed.
+     *
+     *  @arg bufferItem - the data to be pushed into the queue.
+     */
+    bool push(QueueItemT bufferItem) {
+
+        if (_closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        Participant& participant = threadParticipant();
+        size_t slot = participant.index();
+
+        Node* node = new Node{};
+        node->enqueuer = slot;
+        node->item = std::move(bufferItem);
+
+        auto guard = participant.pin();
+
+        uint64_t phase = nextPhase();
+        announce(participant, slot, new Operation{ phase, true, true, node });
+
+        helpUpTo(participant, phase);
+        finishPush(participant);
+
+        return true;
+    }
+
+    /** Pop data from the queue.
+     *
+     *  If there is no data, the thread will return false and will not
+     *  wait for data to become available.
+     *
+     *  @arg popedData - the location to put the extracted data into.
+     *
+     *  @return true if there was data available, false otherwise.
+     */
+    bool pop(QueueItemT& popedData) {
+
+        Participant& participant = threadParticipant();
+        size_t slot = participant.index();
+
+        Node* dummy{ nullptr };
+
+        {
+            auto guard = participant.pin();
+
+            uint64_t phase = nextPhase();
+            announce(participant, slot, new Operation{ phase, true, false, nullptr });
+
+            helpUpTo(participant, phase);
+            finishPop(participant);
+
+            dummy = announcement(slot)->node;
+
+            if (dummy == nullptr) {
+                return false; // The queue was empty when the pop took effect.
+            }
+
+            popedData = std::move(dummy->next.load(std::memory_order_acquire)->item); // Only this pop reads it.
+        }
+
+        participant.retire(dummy); // The head moved past it in finishPop.
+
+        return true;
+    }
+
+    /** Check if there is data in the queue.
+     *
+     * @return true if there is data in the queue, false otherwise.
+     */
+    bool hasData() {
+        auto guard = threadParticipant().pin();
+        return _head.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /** Check if there is space in the queue, which is always the case until it is closed.
+     *
+     * @return true if a push would succeed, false otherwise.
+     */
+    bool hasSpace() {
+        return !isClosed();
+    }
+
+    /** Close the queue.
+     *
+     *  Once it returns every push which starts fails, while the data
+     *  already in the queue can still be poped.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+    }
+
+    /** Check if the queue is closed.
+     *
+     * @return true if the queue is closed, false otherwise.
+     */
+    bool isClosed() {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+private:
+
+    /** The membership of the calling thread in the domain of one queue.
+     */
+    struct ThreadState {
+        uint64_t queueId; // the queue the membership belongs to
+        std::shared_ptr<Shared> shared; // keeps the domain alive for as long as the thread is a member
+        std::unique_ptr<Participant> participant;
+    };
+
+    /** The ids of the queues, which unlike their addresses are never reused.
+     */
+    static std::atomic<uint64_t>& nextQueueId() {
+        static std::atomic<uint64_t> id{ 0 };
+        return id;
+    }
+
+    /** Find the membership of the calling thread, joining the domain on the first use.
+     *
+     *  @return the participant of the calling thread.
+     */
+    Participant& threadParticipant() {
+
+        thread_local std::vector<ThreadState> states{};
+
+        for (ThreadState& state : states) {
+            if (state.queueId == _id) {
+                return *state.participant;
+            }
+        }
+
+        std::erase_if(states, [](const ThreadState& state) { // Leave the queues which are gone.
+            return state.shared->destroyed.load(std::memory_order_acquire);
+        });
+
+        states.push_back(ThreadState{ _id, _shared, std::unique_ptr<Participant>{ new Participant{ _shared->domain.join() } } });
+
+        return *states.back().participant;
+    }
+
+    /** Take a phase larger than the one of every operation announced so far.
+     */
+    uint64_t nextPhase() {
+        return _phase.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    Operation* announcement(size_t slot) {
+        return _shared->announcements[slot].load(std::memory_order_acquire);
+    }
+
+    /** Publish a new operation of the calling thread.
+     *
+     *  @arg participant - the participant of the calling thread.
+     *  @arg slot - the slot of the calling thread.
+     *  @arg operation - the operation.
+     */
+    void announce(Participant& participant, size_t slot, Operation* operation) {
+        participant.retire(_shared->announcements[slot].exchange(operation, std::memory_order_acq_rel));
+    }
+
+    /** Replace the announcement of a slot, if nobody replaced it since it was read.
+     *
+     *  @arg participant - the participant of the calling thread.
+     *  @arg slot - the slot of the operation.
+     *  @arg current - the announcement which was read.
+     *  @arg replacement - the new announcement.
+     */
+    void replace(Participant& participant, size_t slot, Operation* current, Operation replacement) {
+
+        Operation* next = new Operation{ replacement };
+
+        if (_shared->announcements[slot].compare_exchange_strong(current, next, std::memory_order_acq_rel)) {
+            participant.retire(current);
+        }
+        else {
+            delete next; // Never published.
+        }
+    }
+
+    /** Check if the operation of a slot still needs help from an operation of the given phase.
+     */
+    bool isStillPending(size_t slot, uint64_t phase) {
+        Operation* operation = announcement(slot);
+        return operation->pending && operation->phase <= phase;
+    }
+
+    /** Complete every pending operation with a phase up to the given one, including the caller's.
+     *
+     *  @arg participant - the participant of the calling thread.
+     *  @arg phase - the phase of the caller's operation.
+     */
+    void helpUpTo(Participant& participant, uint64_t phase) {
+
+        for (size_t slot = 0; slot < _shared->maxThreads; ++slot) {
+
+            Operation* operation = announcement(slot);
+
+            if (operation->pending && operation->phase <= phase) {
+                if (operation->push) {
+                    helpPush(participant, slot, phase);
+                }
+                else {
+                    helpPop(participant, slot, phase);
+                }
+            }
+        }
+    }
+
+    /** Link the node of a pending push after the tail.
+     *
+     *  @arg participant - the participant of the calling thread.
+     *  @arg slot - the slot of the push.
+     *  @arg phase - the phase of the helping operation.
+     */
+    void helpPush(Participant& participant, size_t slot, uint64_t phase) {
+
+        while (isStillPending(slot, phase)) {
+
+            Node* last = _tail.load(std::memory_order_acquire);
+            Node* next = last->next.load(std::memory_order_acquire);
+
+            if (last != _tail.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            if (next != nullptr) {
+                finishPush(participant); // Complete the push which linked next first.
+                continue;
+            }
+
+            if (isStillPending(slot, phase) &&
+                last->next.compare_exchange_strong(next, announcement(slot)->node, std::memory_order_acq_rel)) {
+                finishPush(participant);
+                return;
+            }
+        }
+    }
+
+    /** Mark the push which linked the node after the tail as done, and move the tail to it.
+     *
+     *  @arg participant - the participant of the calling thread.
+     */
+    void finishPush(Participant& participant) {
+
+        Node* last = _tail.load(std::memory_order_acquire);
+        Node* next = last->next.load(std::memory_order_acquire);
+
+        if (next == nullptr) {
+            return;
+        }
+
+        size_t slot = next->enqueuer;
+        Operation* operation = announcement(slot);
+
+        if (last == _tail.load(std::memory_order_acquire) && operation->node == next) {
+            replace(participant, slot, operation, Operation{ operation->phase, false, true, next });
+            _tail.compare_exchange_strong(last, next, std::memory_order_acq_rel);
+        }
+    }
+
+    /** Give a pending pop the dummy at the head, or mark it as having found the queue empty.
+     *
+     *  @arg participant - the participant of the calling thread.
+     *  @arg slot - the slot of the pop.
+     *  @arg phase - the phase of the helping operation.
+     */
+    void helpPop(Participant& participant, size_t slot, uint64_t phase) {
+
+        while (isStillPending(slot, phase)) {
+
+            Node* first = _head.load(std::memory_order_acquire);
+            Node* last = _tail.load(std::memory_order_acquire);
+            Node* next = first->next.load(std::memory_order_acquire);
+
+            if (first != _head.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            if (first == last) {
+
+                if (next != nullptr) {
+                    finishPush(participant); // A push is half done, complete it and look again.
+                    continue;
+                }
+
+                Operation* operation = announcement(slot);
+
+                if (last == _tail.load(std::memory_order_acquire) && isStillPending(slot, phase)) {
+                    replace(participant, slot, operation, Operation{ operation->phase, false, false, nullptr }); // Empty.
+                }
+                continue;
+            }
+
+            Operation* operation = announcement(slot);
+
+            if (!isStillPending(slot, phase)) {
+                break;
+            }
+
+            if (first == _head.load(std::memory_order_acquire) && operation->node != first) {
+
+                Operation* claimed = new Operation{ operation->phase, true, false, first }; // Aim the pop at this dummy.
+
+                Operation* expected = operation;
+                if (!_shared->announcements[slot].compare_exchange_strong(expected, claimed, std::memory_order_acq_rel)) {
+                    delete claimed;
+                    continue;
+                }
+
+                participant.retire(operation);
+            }
+
+            size_t nobody{ noThread };
+            first->dequeuer.compare_exchange_strong(nobody, slot, std::memory_order_acq_rel); // One pop owns the dummy.
+
+            finishPop(participant);
+        }
+    }
+
+    /** Mark the pop which owns the dummy as done, and move the head past it.
+     *
+     *  @arg participant - the participant of the calling thread.
+     */
+    void finishPop(Participant& participant) {
+
+        Node* first = _head.load(std::memory_order_acquire);
+        Node* next = first->next.load(std::memory_order_acquire);
+
+        size_t slot = first->dequeuer.load(std::memory_order_acquire);
+
+        if (slot == noThread) {
+            return;
+        }
+
+        Operation* operation = announcement(slot);
+
+        if (first == _head.load(std::memory_order_acquire) && next != nullptr) {
+            replace(participant, slot, operation, Operation{ operation->phase, false, false, operation->node });
+            _head.compare_exchange_strong(first, next, std::memory_order_acq_rel);
+        }
+    }
+
+    alignas(cacheLineSize) std::atomic<Node*> _head{ nullptr }; // the dummy node, the data starts after it
+    alignas(cacheLineSize) std::atomic<Node*> _tail{ nullptr }; // the last node, or the one before it
+    alignas(cacheLineSize) std::atomic<uint64_t> _phase{ 0 }; // the phase of the last announced operation
+    std::atomic_bool _closed{ false }; // set once the queue is closed
+    std::shared_ptr<Shared> _shared; // the announcements and the reclamation domain
+    uint64_t _id; // identifies the queue in the memberships of the threads
+};
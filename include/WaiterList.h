@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+
+#include <CoroutineExecutor.h>
+
+/** The intrusive part of a suspended coroutine waiting on a queue.
+ *
+ *  NodeT is the concrete awaiter type, which carries whatever state the
+ *  waker needs to complete the operation on behalf of the coroutine.
+ */
+template<typename NodeT>
+struct WaiterNode {
+    NodeT* next{ nullptr };
+    std::coroutine_handle<> handle{};
+    CoroutineExecutor* executor{ nullptr };
+
+    /** Hand the coroutine over to its executor.
+     *
+     *  The node lives in the coroutine frame, so it must not be touched
+     *  after this call.
+     */
+    void resume() {
+        executor->post(handle);
+    }
+};
+
+/** A lock-free list of suspended coroutines.
+ *
+ *  Waiters are only ever added one by one or removed all at once. Never
+ *  removing a single node avoids the ABA problem and never dereferences a
+ *  node that might have been resumed (and destroyed) by another thread.
+ */
+template<typename NodeT>
+class WaiterList {
+public:
+
+    /** Add a waiter to the list.
+     *
+     *  @arg node - the waiter to add.
+     */
+    void push(NodeT* node) {
+        pushChain(node, node);
+    }
+
+    /** Add a chain of waiters, previously taken with "takeAll", back to the list.
+     *
+     *  @arg first - the first waiter of the chain.
+     *  @arg last - the last waiter of the chain.
+     */
+    void pushChain(NodeT* first, NodeT* last) {
+        NodeT* head = _head.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!_head.compare_exchange_weak(head, first,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    /** Remove every waiter from the list.
+     *
+     *  @return the first waiter of the removed chain, or nullptr if there were no waiters.
+     */
+    NodeT* takeAll() {
+        return _head.load(std::memory_order_relaxed) == nullptr ?
+                    nullptr :
+                    _head.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    /** Remove every waiter from the list, the oldest first.
+     *
+     *  @return the oldest waiter of the removed chain, or nullptr if there were no waiters.
+     */
+    NodeT* takeAllInOrder() {
+        return reverse(takeAll());
+    }
+
+    /** Put back a chain taken with "takeAllInOrder", ahead of the waiters added since.
+     *
+     *  The waiters added since the chain was taken are appended to it, and
+     *  the whole chain is pushed back newest first. Only the waiters added
+     *  between these two steps end up behind it.
+     *
+     *  @arg first - the oldest waiter of the chain.
+     */
+    void putBackInOrder(NodeT* first) {
+
+        NodeT* last = first;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = takeAllInOrder(); // Older than anything added from here on.
+
+        NodeT* newest = reverse(first);
+        pushChain(newest, first);
+    }
+
+    /** Check if there are waiters in the list.
+     *
+     *  @return true if there are no waiters, false otherwise.
+     */
+    bool empty() const {
+        return _head.load(std::memory_order_relaxed) == nullptr;
+    }
+
+private:
+    /** Reverse a chain of waiters.
+     *
+     *  @arg first - the first waiter of the chain, or nullptr.
+     *
+     *  @return the first waiter of the reversed chain.
+     */
+    static NodeT* reverse(NodeT* first) {
+        NodeT* reversed{ nullptr };
+        while (first != nullptr) {
+            NodeT* next = first->next;
+            first->next = reversed;
+            reversed = first;
+            first = next;
+        }
+        return reversed;
+    }
+
+    std::atomic<NodeT*> _head{ nullptr }; // the most recently added waiter
+};
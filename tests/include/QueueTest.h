@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/** Check the data of several producers as one consumer sees it.
+ *
+ *  Producer p pushes p * itemsPerProducer + i for i from 1 to
+ *  itemsPerProducer, so every value tells its producer and its rank.
+ */
+class ProducerOrder {
+public:
+
+    /** A constructor which takes the shape of the data as argument.
+     *
+     *  @arg numberOfProducers - the number of producers.
+     *  @arg itemsPerProducer - the number of items each producer pushes.
+     */
+    ProducerOrder(size_t numberOfProducers, unsigned long long itemsPerProducer)
+    : _last(numberOfProducers, 0),
+      _itemsPerProducer{ itemsPerProducer }
+    {}
+
+    /** Record a value.
+     *
+     *  @arg value - the value just poped.
+     *
+     *  @return true if it comes after the last value seen from its producer, false otherwise.
+     */
+    bool check(unsigned long long value) {
+
+        size_t producer = (value - 1) / _itemsPerProducer;
+
+        bool inOrder = value > _last[producer];
+        _last[producer] = value;
+
+        return inOrder;
+    }
+
+private:
+    std::vector<unsigned long long> _last; // the last value seen from each producer
+    unsigned long long _itemsPerProducer; // the number of items each producer pushes
+};
+
+/** Fill and drain a queue from one thread, many times over.
+ *
+ *  Every round must take exactly capacity items, give them back in order
+ *  and leave the queue empty, and a closed queue must refuse data.
+ *
+ *  @arg queue - an empty queue of unsigned long long.
+ *  @arg capacity - the number of items the queue holds.
+ *  @arg rounds - the number of times the queue is filled.
+ *
+ *  @return true if the queue behaved as a bounded FIFO, false otherwise.
+ */
+template<typename QueueT>
+bool runFifoRounds(QueueT& queue, size_t capacity, size_t rounds = 100) {
+
+    unsigned long long next{ 0 };
+    unsigned long long expected{ 0 };
+
+    for (size_t round = 0; round < rounds; ++round) {
+
+        size_t pushed{ 0 };
+        while (queue.push(next)) {
+            ++next;
+            ++pushed;
+        }
+
+        if (pushed != capacity || queue.hasSpace()) {
+            std::cout << "Capacity " << capacity << " took " << pushed << " items in round " << round << std::endl;
+            return false;
+        }
+
+        unsigned long long data{};
+        for (size_t i = 0; i < capacity; ++i) {
+            if (!queue.pop(data) || data != expected++) {
+                std::cout << "Capacity " << capacity << " lost the order in round " << round << std::endl;
+                return false;
+            }
+        }
+
+        if (queue.hasData() || queue.pop(data) || queue.pop(data)) { // Failed pops must not break the next round.
+            return false;
+        }
+    }
+
+    queue.close();
+
+    return !queue.push(1) && queue.isClosed();
+}
+
+/** Move data from producer threads to consumer threads.
+ *
+ *  The producers retry a failed push, so the queue may be bounded, and
+ *  the consumers run until every item was poped.
+ *
+ *  @arg queue - an empty queue of unsigned long long.
+ *  @arg numberOfProducers - the number of producer threads.
+ *  @arg numberOfConsumers - the number of consumer threads.
+ *  @arg itemsPerProducer - the number of items each producer pushes.
+ *  @arg checkOrder - true if each consumer must see each producer in order.
+ *
+ *  @return true if every item was poped once, in order if checked, false otherwise.
+ */
+template<typename QueueT>
+bool runProducersConsumers(QueueT& queue, size_t numberOfProducers, size_t numberOfConsumers,
+                           unsigned long long itemsPerProducer, bool checkOrder = true) {
+
+    std::vector<std::thread> threads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        threads.emplace_back([&queue, producer, itemsPerProducer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!queue.push(producer * itemsPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::atomic<unsigned long long> remaining{ numberOfProducers * itemsPerProducer };
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<bool> inOrder{ true };
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            ProducerOrder order{ numberOfProducers, itemsPerProducer };
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (!queue.pop(data)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (!order.check(data) && checkOrder) {
+                    inOrder.store(false, std::memory_order_relaxed);
+                }
+
+                sum.fetch_add(data, std::memory_order_relaxed);
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long totalItems = numberOfProducers * itemsPerProducer;
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+
+    std::cout << numberOfProducers << "x" << numberOfConsumers << " Sum: " << sum.load() << " Expected: " << expectedSum << std::endl;
+
+    return sum.load() == expectedSum && inOrder.load() && !queue.hasData();
+}
@@ -0,0 +1,375 @@
+#include <LockFreeQueue.h>
+#include <CoroutineExecutor.h>
+#include <iostream>
+#include <vector>
+
+using QueueT = LockFreeQueue<unsigned long long, 16>;
+
+DetachedTask produce(QueueT& queue, CoroutineExecutor& executor,
+                     unsigned long long first, unsigned long long count,
+                     std::atomic<size_t>& finished) {
+    co_await executor.schedule();
+
+    for (unsigned long long i = 0; i < count; ++i) {
+        co_await queue.asyncPush(executor, first + i);
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+DetachedTask consume(QueueT& queue, CoroutineExecutor& executor,
+                     unsigned long long count,
+                     std::atomic<unsigned long long>& sum,
+                     std::atomic<size_t>& finished) {
+    co_await executor.schedule();
+
+    for (unsigned long long i = 0; i < count; ++i) {
+        std::optional<unsigned long long> data = co_await queue.asyncPop(executor);
+        sum.fetch_add(*data, std::memory_order_relaxed);
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool RunAsyncQueueTest(size_t numberOfProducers, size_t numberOfConsumers, size_t numberOfThreads) {
+
+    const unsigned long long itemsPerConsumer{ 50 };
+    const unsigned long long totalItems{ itemsPerConsumer * numberOfConsumers };
+    const unsigned long long itemsPerProducer{ totalItems / numberOfProducers };
+
+    QueueT queue{ numberOfThreads };
+    CoroutineExecutor executor{};
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<size_t> finished{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+        threads.emplace_back([&executor]() { executor.run(); });
+    }
+
+    // Start the consumers first so most of them have to suspend.
+    for (size_t i = 0; i < numberOfConsumers; ++i) {
+        consume(queue, executor, itemsPerConsumer, sum, finished);
+    }
+
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+        produce(queue, executor, 1 + i * itemsPerProducer, itemsPerProducer, finished);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 60 };
+    while (finished.load(std::memory_order_acquire) != numberOfProducers + numberOfConsumers &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    bool finishedSnap = finished.load(std::memory_order_acquire) == numberOfProducers + numberOfConsumers;
+
+    executor.stop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+    unsigned long long sumSnap = sum.load(std::memory_order_acquire);
+
+    std::cout << "Producers: " << numberOfProducers << " Consumers: " << numberOfConsumers
+              << " Threads: " << numberOfThreads << " Sum: " << sumSnap
+              << " Expected: " << expectedSum << std::endl;
+
+    return finishedSnap &&
+           sumSnap == expectedSum && // Every item was poped exactly once.
+           !queue.hasData();
+}
+
+bool RunMixedQueueTest() {
+
+    const unsigned long long totalItems{ 20000 };
+
+    QueueT queue{ 2 };
+    CoroutineExecutor executor{};
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<size_t> finished{ 0 };
+
+    std::thread executorThread{ [&executor]() { executor.run(); } };
+
+    // Coroutine consumers fed by a plain thread using the synchronous push.
+    for (size_t i = 0; i < 100; ++i) {
+        consume(queue, executor, totalItems / 100, sum, finished);
+    }
+
+    std::thread producerThread{ [&queue, totalItems]() {
+        for (unsigned long long i = 1; i <= totalItems; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    producerThread.join();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 60 };
+    while (finished.load(std::memory_order_acquire) != 100 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    bool finishedSnap = finished.load(std::memory_order_acquire) == 100;
+
+    executor.stop();
+    executorThread.join();
+
+    std::cout << "Mixed Sum: " << sum.load() << std::endl;
+
+    return finishedSnap && sum.load() == totalItems * (totalItems + 1) / 2;
+}
+
+DetachedTask consumeUntilClosed(QueueT& queue, CoroutineExecutor& executor,
+                                std::atomic<unsigned long long>& sum,
+                                std::atomic<size_t>& finished) {
+    co_await executor.schedule();
+
+    while (true) {
+        std::optional<unsigned long long> data = co_await queue.asyncPop(executor);
+        if (!data.has_value()) {
+            break; // The queue is closed and drained.
+        }
+        sum.fetch_add(*data, std::memory_order_relaxed);
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+DetachedTask produceUntilClosed(QueueT& queue, CoroutineExecutor& executor,
+                                std::atomic<size_t>& rejected) {
+    co_await executor.schedule();
+
+    while (true) {
+        bool pushed = co_await queue.asyncPush(executor, 1);
+        if (!pushed) {
+            break; // The queue is closed.
+        }
+    }
+
+    rejected.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool RunCloseTest() {
+
+    const size_t numberOfConsumers{ 500 };
+    const unsigned long long totalItems{ 10 };
+
+    QueueT queue{ 2 };
+    CoroutineExecutor executor{};
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    std::atomic<size_t> rejected{ 0 };
+
+    std::thread executorThread{ [&executor]() { executor.run(); } };
+
+    for (size_t i = 0; i < numberOfConsumers; ++i) {
+        consumeUntilClosed(queue, executor, sum, finished);
+    }
+
+    for (unsigned long long i = 1; i <= totalItems; ++i) {
+        queue.push(i);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 50 }); // Let the consumers suspend.
+
+    queue.close();
+
+    // Producers starting after the close must be rejected straight away.
+    for (size_t i = 0; i < 10; ++i) {
+        produceUntilClosed(queue, executor, rejected);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 60 };
+    while ((finished.load(std::memory_order_acquire) != numberOfConsumers ||
+            rejected.load(std::memory_order_acquire) != 10) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    bool finishedSnap = finished.load(std::memory_order_acquire) == numberOfConsumers &&
+                        rejected.load(std::memory_order_acquire) == 10;
+
+    executor.stop();
+    executorThread.join();
+
+    std::cout << "Close Sum: " << sum.load() << std::endl;
+
+    return finishedSnap && sum.load() == totalItems * (totalItems + 1) / 2 && !queue.push(1);
+}
+
+bool RunClosePushWaitersTest() {
+
+    QueueT queue{ 2 };
+    CoroutineExecutor executor{};
+    std::atomic<size_t> rejected{ 0 };
+
+    std::thread executorThread{ [&executor]() { executor.run(); } };
+
+    // Fill the queue so every producer ends up suspended.
+    for (size_t i = 0; i < 100; ++i) {
+        produceUntilClosed(queue, executor, rejected);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+
+    queue.close();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 60 };
+    while (rejected.load(std::memory_order_acquire) != 100 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    bool finishedSnap = rejected.load(std::memory_order_acquire) == 100;
+
+    executor.stop();
+    executorThread.join();
+
+    return finishedSnap;
+}
+
+DetachedTask popOnce(QueueT& queue, CoroutineExecutor& executor, size_t id, std::vector<unsigned long long>& results) {
+    std::optional<unsigned long long> data = co_await queue.asyncPop(executor);
+    results[id] = data.value_or(0);
+}
+
+bool RunFairnessTest() {
+
+    const size_t numberOfConsumers{ 100 };
+
+    QueueT queue{ 1 };
+    CoroutineExecutor executor{};
+    std::vector<unsigned long long> results(numberOfConsumers, 0);
+
+    for (size_t id = 0; id < numberOfConsumers; ++id) {
+        popOnce(queue, executor, id, results); // Suspends straight away on the empty queue.
+    }
+
+    for (unsigned long long i = 1; i <= numberOfConsumers; ++i) {
+        queue.push(i);
+        while (executor.runOne()) {
+        }
+    }
+
+    for (size_t id = 0; id < numberOfConsumers; ++id) {
+        if (results[id] != id + 1) { // The consumer which waited the longest is served first.
+            std::cout << "Consumer " << id << " got " << results[id] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct CountingNotifier : QueueNotifier {
+    void notify() override { count.fetch_add(1, std::memory_order_relaxed); }
+    std::atomic<size_t> count{ 0 };
+};
+
+bool RunServedPushAnnouncedTest() {
+
+    QueueT queue{ 2 };
+    CoroutineExecutor executor{};
+    CountingNotifier notifier{};
+
+    unsigned long long data{ 0 };
+    while (queue.push(data)) {
+        ++data;
+    }
+
+    QueueT::PushAwaiter awaiter = queue.asyncPush(executor, 1000);
+    if (awaiter.await_ready()) { // The queue is full, the producer is about to suspend.
+        return false;
+    }
+
+    while (queue.pop(data)) { // Space is freed before the producer is in the waiter list.
+    }
+
+    queue.setNotifier(&notifier);
+
+    QueueStatus status{ QueueStatus::Timeout };
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer{ [&queue, &status, &data]() {
+        status = queue.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 10 });
+    } };
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 50 }); // Let the consumer go to sleep.
+
+    awaiter.await_suspend(std::noop_coroutine()); // Finds the space and pushes on its own behalf.
+
+    consumer.join();
+
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Served push woke popUntil after " << std::chrono::duration_cast<std::chrono::milliseconds>(waited).count()
+              << "ms" << std::endl;
+
+    return status == QueueStatus::Success && data == 1000 && waited < std::chrono::seconds{ 5 } &&
+           notifier.count.load() != 0;
+}
+
+bool RunServedPopAnnouncedTest() {
+
+    QueueT queue{ 2 };
+    CoroutineExecutor executor{};
+
+    QueueT::PopAwaiter awaiter = queue.asyncPop(executor);
+    if (awaiter.await_ready()) { // The queue is empty, the consumer is about to suspend.
+        return false;
+    }
+
+    unsigned long long data{ 0 };
+    while (queue.push(data)) { // Data is pushed before the consumer is in the waiter list.
+        ++data;
+    }
+
+    queue.setOverflowPolicy({ OverflowAction::Block, std::chrono::seconds{ 5 } });
+
+    QueueStatus status{ QueueStatus::Timeout };
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer{ [&queue, &status]() {
+        status = queue.offer(1000);
+    } };
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 50 }); // Let the producer go to sleep.
+
+    awaiter.await_suspend(std::noop_coroutine()); // Finds the data and pops on its own behalf.
+
+    producer.join();
+
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Served pop woke offer after " << std::chrono::duration_cast<std::chrono::milliseconds>(waited).count()
+              << "ms" << std::endl;
+
+    std::optional<unsigned long long> poped = awaiter.await_resume();
+
+    return status == QueueStatus::Success && poped == 0ULL && waited < std::chrono::seconds{ 2 };
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunAsyncQueueTest(1, 1, 1) ||
+        !RunAsyncQueueTest(10, 1000, 4) ||
+        !RunAsyncQueueTest(250, 10, 4) ||
+        !RunMixedQueueTest() ||
+        !RunCloseTest() ||
+        !RunClosePushWaitersTest() ||
+        !RunFairnessTest() ||
+        !RunServedPushAnnouncedTest() ||
+        !RunServedPopAnnouncedTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <BroadcastRing.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+bool RunGatingTest() {
+
+    BroadcastRing<int, 4> ring{ 2 };
+
+    for (int i = 0; i < 4; ++i) {
+        if (!ring.push(i)) {
+            std::cout << "The ring must accept bufferSize items!" << std::endl;
+            return false;
+        }
+    }
+
+    if (ring.push(4)) {
+        std::cout << "The producer must wait for the slowest consumer!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 4; ++i) {
+        if (!ring.pop(0, data) || data != i) {
+            return false;
+        }
+    }
+
+    if (ring.push(4)) {
+        std::cout << "Consumer 1 has not read anything yet!" << std::endl;
+        return false;
+    }
+
+    if (!ring.pop(1, data) || data != 0 || !ring.push(4)) {
+        return false;
+    }
+
+    return ring.hasData(0) && ring.pop(0, data) && data == 4 && !ring.hasData(0);
+}
+
+bool RunBroadcastTest() {
+
+    const size_t numberOfConsumers{ 4 };
+    const unsigned long long totalItems{ 1000000 };
+
+    BroadcastRing<unsigned long long, 1024> ring{ numberOfConsumers };
+    std::vector<bool> inOrder(numberOfConsumers, false);
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&ring, &inOrder, consumer, totalItems]() {
+            unsigned long long expected{ 1 };
+            while (expected <= totalItems) {
+                unsigned long long data{};
+                if (ring.pop(consumer, data)) {
+                    if (data != expected) {
+                        return; // Every consumer must see every item, in order.
+                    }
+                    ++expected;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            inOrder.at(consumer) = true;
+        });
+    }
+
+    for (unsigned long long value = 1; value <= totalItems; ++value) {
+        while (!ring.push(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        if (!inOrder.at(consumer)) {
+            std::cout << "Consumer " << consumer << " missed data!" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunGatingTest() ||
+        !RunBroadcastTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
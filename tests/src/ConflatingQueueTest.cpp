@@ -0,0 +1,124 @@
+#include <ConflatingQueue.h>
+#include <QueueTopology.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static_assert(QueueEngine<ConflatingQueue<unsigned long long, unsigned long long, 64>>);
+
+bool RunSingleThreadTest() {
+
+    ConflatingQueue<std::string, int, 4> queue{};
+
+    if (!queue.push("A", 1) || !queue.push("B", 2) || !queue.push("A", 3) || queue.conflated() != 1) {
+        return false;
+    }
+
+    std::pair<std::string, int> data{};
+
+    if (!queue.pop(data) || data.first != "A" || data.second != 3) { // A waited the longest, with its latest value.
+        return false;
+    }
+
+    if (!queue.pop(data) || data.first != "B" || data.second != 2 || queue.hasData() || queue.pop(data)) {
+        return false;
+    }
+
+    if (!queue.push("C", 4) || !queue.push("D", 5) || queue.push("E", 6) || queue.hasSpace()) { // Bounded by the keys.
+        std::cout << "A fifth key was accepted" << std::endl;
+        return false;
+    }
+
+    if (!queue.push({ "A", 7 }) || !queue.pop(data) || data.first != "C" || !queue.pop(data) || !queue.pop(data) || data.second != 7) {
+        return false;
+    }
+
+    queue.close();
+
+    return !queue.push("A", 8) && queue.isClosed();
+}
+
+bool RunThreadedTest(size_t numberOfProducers, size_t numberOfConsumers) {
+
+    const unsigned long long keysPerProducer{ 16 };
+    const unsigned long long updatesPerKey{ 20000 };
+
+    ConflatingQueue<unsigned long long, unsigned long long, 256> queue{};
+
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::vector<std::atomic<unsigned long long>> latest(numberOfProducers * keysPerProducer);
+    std::atomic<bool> inOrder{ true };
+    std::atomic<unsigned long long> poped{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        threads.emplace_back([&, producer]() {
+            for (unsigned long long version = 1; version <= updatesPerKey; ++version) {
+                for (unsigned long long key = 0; key < keysPerProducer; ++key) {
+                    while (!queue.push(producer * keysPerProducer + key, version)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            std::vector<unsigned long long> last(latest.size(), 0);
+            std::pair<unsigned long long, unsigned long long> data{};
+            while (true) {
+                bool done = producing.load(std::memory_order_acquire) == 0;
+                if (!queue.pop(data)) {
+                    if (done) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (data.second <= last[data.first]) {
+                    inOrder.store(false, std::memory_order_relaxed); // A consumer never sees an older value of a key.
+                }
+                last[data.first] = data.second;
+
+                unsigned long long seen = latest[data.first].load(std::memory_order_relaxed);
+                while (seen < data.second && !latest[data.first].compare_exchange_weak(seen, data.second, std::memory_order_relaxed)) {
+                }
+
+                poped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool allLatest{ true };
+    for (auto& version : latest) {
+        allLatest = allLatest && version.load() == updatesPerKey; // The last update of every key got through.
+    }
+
+    unsigned long long totalUpdates = numberOfProducers * keysPerProducer * updatesPerKey;
+
+    std::cout << numberOfProducers << "x" << numberOfConsumers << " Poped: " << poped.load()
+              << " Conflated: " << queue.conflated() << " Total: " << totalUpdates << std::endl;
+
+    return allLatest && inOrder.load() && poped.load() + queue.conflated() == totalUpdates;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunSingleThreadTest() || !RunThreadedTest(1, 1) || !RunThreadedTest(4, 4) || !RunThreadedTest(8, 2)) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
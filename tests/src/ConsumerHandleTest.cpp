@@ -0,0 +1,106 @@
+#include <LockFreeQueue.h>
+#include <iostream>
+#include <vector>
+
+bool RunRunTest() {
+
+    LockFreeQueue<int, 16> queue{ 2 };
+
+    for (int i = 0; i < 10; ++i) {
+        queue.push(i);
+    }
+
+    int data{};
+
+    {
+        auto handle = queue.consumerHandle(4);
+
+        for (int i = 0; i < 6; ++i) {
+            if (!handle.pop(data) || data != i) {
+                std::cout << "The handle must keep the order!" << std::endl;
+                return false;
+            }
+        }
+
+        if (handle.claimed() != 2) {
+            std::cout << "The handle must claim batchSize items at once!" << std::endl;
+            return false;
+        }
+    } // 6 and 7 are pushed back behind 8 and 9.
+
+    std::vector<int> expected{ 8, 9, 6, 7 };
+    for (int value : expected) {
+        if (!queue.pop(data) || data != value) {
+            std::cout << "Leftover items must be pushed back, expected " << value << " got " << data << std::endl;
+            return false;
+        }
+    }
+
+    return !queue.pop(data) && !queue.hasData();
+}
+
+template<typename QueueT>
+bool RunManyConsumersTest(const char* name, size_t numberOfConsumers) {
+
+    const unsigned long long numberOfItems{ 400000 };
+
+    QueueT queue{ numberOfConsumers + 1 };
+
+    std::thread producerThread{ [&queue, numberOfItems]() {
+        for (unsigned long long i = 1; i <= numberOfItems; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    std::atomic<unsigned long long> remaining{ numberOfItems };
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<bool> inOrder{ true };
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&queue, &remaining, &sum, &inOrder]() {
+            auto handle = queue.consumerHandle(16);
+            unsigned long long last{ 0 };
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                unsigned long long data{};
+                if (handle.pop(data)) {
+                    if (data <= last) {
+                        inOrder.store(false, std::memory_order_relaxed); // A single producer, every consumer sees increasing values.
+                    }
+                    last = data;
+                    sum.fetch_add(data, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    producerThread.join();
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    std::cout << name << " Sum: " << sum.load() << std::endl;
+
+    return inOrder.load() && sum.load() == numberOfItems * (numberOfItems + 1) / 2 && !queue.hasData();
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunRunTest() ||
+        !RunManyConsumersTest<LockFreeQueue<unsigned long long, 64>>("MPMC", 4) ||
+        !RunManyConsumersTest<LockFreeQueue<unsigned long long, 64, Producers::Single, Consumers::Single>>("SPSC", 1)) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <MpmcQueue.h>
+#include <QueueTest.h>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <sys/time.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+bool RunLowOccupancyTest(size_t numberOfProducers, size_t numberOfConsumers) {
+
+    MpmcQueue<unsigned long long, 8> queue{ numberOfProducers + numberOfConsumers };
+
+    bool passed = runProducersConsumers(queue, numberOfProducers, numberOfConsumers, 50000);
+
+    std::cout << "Eliminated: " << queue.eliminations() << std::endl;
+
+    return passed;
+}
+
+void stallThread(int) {
+    std::this_thread::sleep_for(std::chrono::microseconds{ 500 }); // Often inside the critical section.
+}
+
+bool RunExchangeRound(size_t numberOfConsumers, size_t& eliminated) {
+
+    const unsigned long long numberOfItems{ 25000 };
+    const unsigned long long backlog{ 20000 };
+
+    auto queue = std::make_unique<MpmcQueue<unsigned long long, 32768>>(numberOfConsumers + 1);
+
+    for (unsigned long long i = 1; i <= backlog; ++i) { // While it drains, no item may be handed over.
+        queue->push(i);
+    }
+
+    std::atomic<unsigned long long> remaining{ numberOfItems };
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<unsigned long long> latest{ 0 }; // the newest item whose pop returned
+    std::atomic<bool> inOrder{ true };
+
+    // The consumers poll without yielding, so the producer keeps finding the critical section taken
+    // and, once the backlog is gone, hands its data to a consumer waiting in an exchanger.
+    std::vector<std::thread> threads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                unsigned long long before = latest.load(std::memory_order_seq_cst);
+                if (!queue->pop(data)) {
+                    continue;
+                }
+
+                if (data < before) {
+                    inOrder.store(false, std::memory_order_relaxed); // Poped after a newer item was: it was overtaken.
+                }
+
+                unsigned long long seen = latest.load(std::memory_order_relaxed);
+                while (seen < data && !latest.compare_exchange_weak(seen, data, std::memory_order_seq_cst)) {
+                }
+
+                sum.fetch_add(data, std::memory_order_relaxed);
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // The profiling timer stalls whichever thread runs, so the others find the critical
+    // section held by a sleeping thread, even when they share a single CPU.
+    std::signal(SIGPROF, stallThread);
+    itimerval period{ { 0, 1000 }, { 0, 1000 } };
+    setitimer(ITIMER_PROF, &period, nullptr);
+
+    for (unsigned long long i = backlog + 1; i <= numberOfItems; ++i) {
+        while (!queue->push(i)) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    itimerval stop{};
+    setitimer(ITIMER_PROF, &stop, nullptr);
+    std::signal(SIGPROF, SIG_DFL);
+
+    eliminated = queue->eliminations();
+
+    std::cout << "1x" << numberOfConsumers << " Sum: " << sum.load() << " Eliminated: " << eliminated << std::endl;
+
+    return inOrder.load() && sum.load() == numberOfItems * (numberOfItems + 1) / 2;
+}
+
+bool RunExchangeTest(size_t numberOfConsumers) {
+
+    size_t total{ 0 };
+
+    for (size_t round = 0; round < 20; ++round) { // An exchange needs both sides to miss the critical section.
+        size_t eliminated{ 0 };
+        if (!RunExchangeRound(numberOfConsumers, eliminated)) {
+            return false;
+        }
+        total += eliminated;
+        if (total != 0 && round >= 9) {
+            return true;
+        }
+    }
+
+    std::cout << "No push and pop met in an exchanger" << std::endl;
+    return false;
+}
+
+bool RunClosedTest() {
+
+    MpmcQueue<unsigned long long, 8> queue{ 2 };
+
+    queue.close();
+
+    return !queue.push(1) && queue.eliminations() == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunLowOccupancyTest(1, 1) || !RunLowOccupancyTest(4, 4) || !RunLowOccupancyTest(2, 8) ||
+        !RunExchangeTest(4) || !RunClosedTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include <EpochReclamation.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+std::atomic<long long> liveNodes{ 0 };
+
+struct Node {
+    explicit Node(unsigned long long nodeValue) : value{ nodeValue } {
+        liveNodes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~Node() {
+        canary = 0; // A reader seeing this was reading freed memory.
+        liveNodes.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    unsigned long long value{ 0 };
+    unsigned long long canary{ 0xC0FFEE };
+};
+
+bool RunBatchTest() {
+
+    {
+        EpochReclamation<> domain{ 4, 8 };
+        auto participant = domain.join();
+
+        for (unsigned long long i = 0; i < 7; ++i) {
+            participant.retire(new Node{ i });
+        }
+
+        if (participant.pending() != 7) {
+            std::cout << "Nodes must be freed in batches!" << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < 3; ++i) { // Each reclaim advances the epoch by one.
+            participant.reclaim();
+        }
+
+        if (participant.pending() != 0 || liveNodes.load() != 0) {
+            std::cout << "Nodes retired two epochs ago must be freed!" << std::endl;
+            return false;
+        }
+
+        participant.retire(new Node{ 8 });
+    } // The domain frees what the participant left behind.
+
+    return liveNodes.load() == 0;
+}
+
+bool RunPinnedReaderTest() {
+
+    EpochReclamation<> domain{ 4, 1 };
+    auto writer = domain.join();
+
+    std::atomic<int> step{ 0 };
+
+    std::thread readerThread{ [&domain, &step]() {
+        auto reader = domain.join();
+        auto guard = reader.pin();
+        step.store(1);
+        while (step.load() != 2) {
+            std::this_thread::yield();
+        }
+    } };
+
+    while (step.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    for (unsigned long long i = 0; i < 100; ++i) {
+        writer.retire(new Node{ i });
+    }
+
+    bool held = writer.pending() >= 99; // The pinned reader holds the epoch back.
+
+    step.store(2);
+    readerThread.join();
+
+    for (size_t i = 0; i < 3; ++i) {
+        writer.reclaim();
+    }
+
+    return held && writer.pending() == 0 && liveNodes.load() == 0;
+}
+
+bool RunHazardPointerTest() {
+
+    EpochReclamation<1> domain{ 4, 1 };
+    auto writer = domain.join();
+
+    std::atomic<Node*> shared{ new Node{ 1 } };
+    std::atomic<int> step{ 0 };
+    bool readerOk{ false };
+
+    std::thread readerThread{ [&]() {
+        auto reader = domain.join();
+        Node* node = reader.protect(0, shared); // Not pinned, the epoch keeps moving.
+        step.store(1);
+        while (step.load() != 2) {
+            std::this_thread::yield();
+        }
+        readerOk = node->canary == 0xC0FFEE && node->value == 1;
+        reader.clear(0);
+    } };
+
+    while (step.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    Node* old = shared.exchange(new Node{ 2 });
+    writer.retire(old);
+
+    for (unsigned long long i = 0; i < 100; ++i) {
+        writer.retire(new Node{ i });
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        writer.reclaim();
+    }
+
+    bool protectedOnly = writer.pending() == 1; // Everything but the protected node was freed.
+
+    step.store(2);
+    readerThread.join();
+
+    writer.reclaim();
+
+    delete shared.load();
+
+    return readerOk && protectedOnly && writer.pending() == 0 && liveNodes.load() == 0;
+}
+
+bool RunStressTest() {
+
+    const size_t numberOfWriters{ 2 };
+    const size_t numberOfReaders{ 4 };
+    const unsigned long long swapsPerWriter{ 100000 };
+
+    EpochReclamation<> domain{ numberOfWriters + numberOfReaders };
+
+    std::atomic<Node*> shared{ new Node{ 0 } };
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> corrupted{ 0 };
+
+    std::vector<std::thread> threads{};
+
+    for (size_t writer = 0; writer < numberOfWriters; ++writer) {
+        threads.emplace_back([&domain, &shared, swapsPerWriter]() {
+            auto participant = domain.join();
+            for (unsigned long long i = 1; i <= swapsPerWriter; ++i) {
+                Node* old = shared.exchange(new Node{ i }, std::memory_order_acq_rel);
+                participant.retire(old);
+            }
+        });
+    }
+
+    for (size_t reader = 0; reader < numberOfReaders; ++reader) {
+        threads.emplace_back([&domain, &shared, &done, &corrupted]() {
+            auto participant = domain.join();
+            while (!done.load(std::memory_order_relaxed)) {
+                auto guard = participant.pin();
+                Node* node = shared.load(std::memory_order_acquire);
+                for (int i = 0; i < 10; ++i) {
+                    if (node->canary != 0xC0FFEE) {
+                        corrupted.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+
+    for (size_t writer = 0; writer < numberOfWriters; ++writer) {
+        threads.at(writer).join();
+    }
+
+    done.store(true);
+
+    for (size_t reader = numberOfWriters; reader < threads.size(); ++reader) {
+        threads.at(reader).join();
+    }
+
+    {
+        auto participant = domain.join();
+        for (size_t i = 0; i < 3; ++i) {
+            participant.reclaim(); // Adopts and frees what the others left behind.
+        }
+    }
+
+    delete shared.load();
+
+    std::cout << "Stress corrupted reads: " << corrupted.load() << " live nodes: " << liveNodes.load() << std::endl;
+
+    return corrupted.load() == 0 && liveNodes.load() == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunBatchTest() ||
+        !RunPinnedReaderTest() ||
+        !RunHazardPointerTest() ||
+        !RunStressTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <LockFreeQueue.h>
+#include <EventFdNotifier.h>
+#include <iostream>
+#include <vector>
+
+#include <poll.h>
+#include <sys/epoll.h>
+
+using QueueT = LockFreeQueue<unsigned long long, 1024>;
+
+bool isReadable(int fd) {
+    pollfd pollFd{ fd, POLLIN, 0 };
+    return poll(&pollFd, 1, 0) == 1;
+}
+
+bool RunCoalescingTest() {
+
+    QueueT queue{ 2 };
+    EventFdNotifier notifier{};
+    queue.setNotifier(&notifier);
+
+    for (unsigned long long i = 0; i < 1000; ++i) {
+        queue.push(i);
+    }
+
+    if (notifier.signalCount() != 1 || !isReadable(notifier.nativeHandle())) {
+        std::cout << "A burst must signal exactly once!" << std::endl;
+        return false;
+    }
+
+    size_t handled{ 0 };
+    auto handler = [&handled](unsigned long long) { ++handled; };
+
+    if (notifier.drain(queue, handler, 100) != 100 || !isReadable(notifier.nativeHandle())) {
+        std::cout << "A partial drain must leave the eventfd readable!" << std::endl;
+        return false;
+    }
+
+    while (notifier.drain(queue, handler, 100) != 0) {}
+
+    if (handled != 1000 || isReadable(notifier.nativeHandle()) || notifier.signalCount() != 1) {
+        std::cout << "A full drain must clear the eventfd!" << std::endl;
+        return false;
+    }
+
+    queue.push(1);
+
+    return notifier.signalCount() == 2 && isReadable(notifier.nativeHandle());
+}
+
+/** A queue whose only push is stuck in the middle of its copy.
+ */
+struct StalledQueue {
+    using ItemType = unsigned long long;
+
+    bool pop(ItemType&) { return false; }
+    bool hasData() { ++hasDataCalls; return hasDataCalls < 1000; }
+
+    size_t hasDataCalls{ 0 };
+};
+
+bool RunStalledPushTest() {
+
+    StalledQueue queue{};
+    EventFdNotifier notifier{};
+
+    notifier.notify(); // The stalled push was announced earlier.
+
+    size_t handled = notifier.drain(queue, [](unsigned long long) {}, 100);
+
+    if (handled != 0 || queue.hasDataCalls > 2 || isReadable(notifier.nativeHandle())) {
+        std::cout << "Drain spun on a stalled push: " << queue.hasDataCalls << " checks" << std::endl;
+        return false;
+    }
+
+    notifier.notify(); // The stalled push completes, the notifier must be armed for it.
+
+    return notifier.signalCount() == 2 && isReadable(notifier.nativeHandle());
+}
+
+bool RunEpollLoopTest() {
+
+    const size_t numberOfProducers{ 4 };
+    const unsigned long long itemsPerProducer{ 50000 };
+
+    QueueT queue{ numberOfProducers + 1 };
+    EventFdNotifier notifier{};
+    queue.setNotifier(&notifier);
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = notifier.nativeHandle();
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, notifier.nativeHandle(), &event);
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+        producerThreads.emplace_back([&queue, itemsPerProducer]() {
+            for (unsigned long long value = 1; value <= itemsPerProducer; ++value) {
+                while (!queue.push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    unsigned long long sum{ 0 };
+    unsigned long long count{ 0 };
+    size_t wakeUps{ 0 };
+
+    while (count < numberOfProducers * itemsPerProducer) {
+        epoll_event ready{};
+        if (epoll_wait(epollFd, &ready, 1, 10000) != 1) {
+            std::cout << "The epoll loop timed out!" << std::endl;
+            break;
+        }
+        ++wakeUps;
+        notifier.drain(queue, [&sum, &count](unsigned long long value) { sum += value; ++count; }, 64);
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+
+    close(epollFd);
+
+    std::cout << "Items: " << count << " Wake ups: " << wakeUps
+              << " Signals: " << notifier.signalCount() << std::endl;
+
+    return sum == numberOfProducers * itemsPerProducer * (itemsPerProducer + 1) / 2 &&
+           notifier.signalCount() <= count;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunCoalescingTest() ||
+        !RunStalledPushTest() ||
+        !RunEpollLoopTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
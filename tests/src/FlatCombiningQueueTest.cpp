@@ -0,0 +1,181 @@
+#include <FlatCombiningQueue.h>
+#include <QueueTest.h>
+#include <QueueTopology.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static_assert(QueueEngine<FlatCombiningQueue<unsigned long long, 64>>);
+
+std::function<void(unsigned long long)> onCopyIntoRing{}; // run by the combiner as it copies an item into the ring
+
+/** An item which lets a test act while the combiner copies it into the ring.
+ */
+struct TracedItem {
+
+    unsigned long long value{ 0 };
+    size_t moves{ 0 }; // the number of times the item was moved, the second one is into the ring
+
+    TracedItem() = default;
+    TracedItem(unsigned long long value) : value{ value } {}
+    TracedItem(const TracedItem&) = default;
+    TracedItem& operator=(const TracedItem&) = default;
+
+    TracedItem& operator=(TracedItem&& other) {
+
+        value = other.value;
+        moves = other.moves + 1;
+
+        if (moves == 2 && onCopyIntoRing) {
+            onCopyIntoRing(value);
+        }
+
+        return *this;
+    }
+};
+
+template<size_t bufferSize>
+bool RunSingleThreadTest() {
+
+    FlatCombiningQueue<unsigned long long, bufferSize> queue{};
+
+    return runFifoRounds(queue, bufferSize); // Many laps of the ring.
+}
+
+bool RunThreadedTest(size_t numberOfProducers, size_t numberOfConsumers, size_t numberOfSlots) {
+
+    FlatCombiningQueue<unsigned long long, 64> queue{ numberOfSlots };
+
+    return runProducersConsumers(queue, numberOfProducers, numberOfConsumers, 100000);
+}
+
+bool RunStalledCombinerTest(size_t numberOfSlots) {
+
+    const size_t numberOfProducers{ 3 };
+    const unsigned long long stalledValue{ 1000 };
+
+    FlatCombiningQueue<TracedItem, 8> queue{ numberOfSlots };
+
+    std::atomic<bool> stalling{ true };
+    std::atomic<bool> stalled{ false };
+
+    onCopyIntoRing = [&](unsigned long long value) {
+        if (value == stalledValue) {
+            stalled.store(true, std::memory_order_release);
+            while (stalling.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::thread stalledThread([&queue, stalledValue]() {
+        queue.push(TracedItem{ stalledValue });
+    });
+
+    while (!stalled.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    // With free slots the producers publish and wait for the combiner, with one slot they wait for the slot.
+    std::atomic<size_t> done{ 0 };
+    std::vector<std::thread> producers{};
+    for (size_t producer = 1; producer <= numberOfProducers; ++producer) {
+        producers.emplace_back([&queue, &done, producer]() {
+            queue.push(TracedItem{ producer });
+            done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+    bool heldUp = done.load(std::memory_order_acquire) == 0;
+
+    stalling.store(false, std::memory_order_release); // The combiner resumes, it or a waiting thread serves the rest.
+
+    stalledThread.join();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    onCopyIntoRing = nullptr;
+
+    TracedItem data{};
+    if (!heldUp || !queue.pop(data) || data.value != stalledValue) {
+        std::cout << numberOfSlots << " slots: the stalled push did not come first" << std::endl;
+        return false;
+    }
+
+    unsigned long long sum{ 0 };
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+        if (!queue.pop(data)) {
+            std::cout << numberOfSlots << " slots: a push published during the stall was lost" << std::endl;
+            return false;
+        }
+        sum += data.value;
+    }
+
+    return sum == numberOfProducers * (numberOfProducers + 1) / 2 && !queue.hasData();
+}
+
+bool RunHandoverTest() {
+
+    const size_t numberOfProducers{ 40 };
+
+    FlatCombiningQueue<TracedItem, 64> queue{ 4 };
+
+    std::atomic<size_t> copied{ 0 };
+    std::vector<std::thread> producers{};
+
+    // Every copy into the ring starts one more producer and gives it the time to publish, so the combiner always
+    // finds a new request: it must still hand over to a waiting thread after a few passes and get back to its caller.
+    onCopyIntoRing = [&](unsigned long long) {
+        size_t count = copied.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (count <= numberOfProducers) {
+            producers.emplace_back([&queue, count]() { // Under the combiner lock, one thread at a time.
+                queue.push(TracedItem{ count });
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+        }
+    };
+
+    queue.push(TracedItem{ 0 });
+    size_t copiedForCaller = copied.load(std::memory_order_acquire);
+
+    while (copied.load(std::memory_order_acquire) != numberOfProducers + 1) {
+        std::this_thread::yield();
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    onCopyIntoRing = nullptr;
+
+    std::cout << "The first combiner served " << copiedForCaller << " of " << numberOfProducers + 1 << " pushes" << std::endl;
+
+    unsigned long long sum{ 0 };
+    TracedItem data{};
+    while (queue.pop(data)) {
+        sum += data.value;
+    }
+
+    return copiedForCaller < numberOfProducers + 1 && sum == numberOfProducers * (numberOfProducers + 1) / 2;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunSingleThreadTest<1>() || !RunSingleThreadTest<5>() || !RunSingleThreadTest<64>() ||
+        !RunThreadedTest(1, 1, 64) || !RunThreadedTest(4, 4, 64) || !RunThreadedTest(8, 2, 64) ||
+        !RunThreadedTest(4, 4, 2) || // More threads than slots.
+        !RunThreadedTest(2, 2, 0) || // Clamped to one slot.
+        !RunStalledCombinerTest(4) || !RunStalledCombinerTest(1) || !RunHandoverTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <LockFreeQueue.h>
+#include <iostream>
+#include <thread>
+
+bool RunPreemptedProducerTest() {
+
+    MpmcQueue<unsigned long long, 8> queue{ 3 };
+
+    // A producer claims the head index and is "preempted" before copying into it.
+    size_t first{};
+    if (queue.claimSpaces(1, first) != 1 || !queue.push(2) || !queue.push(3)) {
+        return false;
+    }
+
+    std::atomic<bool> waiting{ false };
+    unsigned long long stalled{ 0 };
+
+    std::thread consumer{ [&]() {
+        waiting.store(true, std::memory_order_release);
+        if (!queue.pop(stalled)) {
+            stalled = 0;
+        }
+    } };
+
+    while (!waiting.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 }); // Let the consumer claim the in-flight index.
+
+    // The other consumers move on past the in-flight index.
+    unsigned long long second{};
+    unsigned long long third{};
+    bool progressed = queue.pop(second) && queue.pop(third) && second == 2 && third == 3;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+    queue.claimedItem(first) = 1; // The producer is scheduled again and publishes.
+    queue.publishClaimed(first, 1);
+
+    consumer.join();
+
+    auto stalls = queue.stallStatistics();
+
+    std::cout << "Progressed: " << progressed << " Stalled item: " << stalled
+              << " Stalls: " << stalls.count << " Longest: " << stalls.longest.count() << "ns" << std::endl;
+
+    return progressed && stalled == 1 && stalls.count == 1 &&
+           stalls.longest >= std::chrono::milliseconds{ 20 } && stalls.total == stalls.longest && !queue.hasData();
+}
+
+bool RunThreadedTest() {
+
+    const size_t numberOfProducers{ 4 };
+    const size_t numberOfConsumers{ 4 };
+    const unsigned long long itemsPerProducer{ 100000 };
+
+    LockFreeQueue<unsigned long long, 16> queue{ numberOfProducers + numberOfConsumers };
+
+    std::vector<std::thread> threads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        threads.emplace_back([&queue, producer, itemsPerProducer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!queue.push(producer * itemsPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::atomic<unsigned long long> remaining{ numberOfProducers * itemsPerProducer };
+    std::atomic<unsigned long long> sum{ 0 };
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.pop(data)) {
+                    sum.fetch_add(data, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long totalItems = numberOfProducers * itemsPerProducer;
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+
+    auto stalls = queue.stallStatistics();
+
+    std::cout << "Sum: " << sum.load() << " Expected: " << expectedSum
+              << " Stalls: " << stalls.count << " Longest: " << stalls.longest.count() << "ns" << std::endl;
+
+    return sum.load() == expectedSum && !queue.hasData() && stalls.total >= stalls.longest;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunPreemptedProducerTest() || !RunThreadedTest()) {
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -117,6 +117,36 @@ private:
     std::atomic<unsigned long long>& _dataCounter;
 };
 
+template<typename QueueT, typename TData>
+class ClosingConsumer
+{
+public:
+    ClosingConsumer(QueueT& queue, std::atomic<unsigned long long>& dataCounter)
+        : _queue{ queue }, _dataCounter{ dataCounter }
+    {}
+
+    ~ClosingConsumer() = default;
+
+    void run() {
+        while (true) {
+            TData data{};
+            QueueStatus status = _queue.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 1 });
+
+            if (status == QueueStatus::Closed) {
+                return; // The queue is closed and drained.
+            }
+
+            if (status == QueueStatus::Success) {
+                data->poped();
+                _dataCounter.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+private:
+    QueueT& _queue;
+    std::atomic<unsigned long long>& _dataCounter;
+};
+
 bool RunLockFreeQueueTest() {
     using DataT = std::shared_ptr<QueueChecker>;
     using QueueT = LockFreeQueue<DataT, 100>;
@@ -190,9 +220,163 @@ bool RunLockFreeQueueTest() {
         !hasDataSnap; // We should have no pending data in the queue.
 }
 
+bool RunLockFreeQueueCloseTest() {
+    using DataT = std::shared_ptr<QueueChecker>;
+    using QueueT = LockFreeQueue<DataT, 100>;
+
+    size_t numberOfProducers{ 8 };
+    size_t numberOfConsumers{ 8 };
+
+    QueueT queue{numberOfProducers+numberOfConsumers};
+    std::atomic_bool ok{ true };
+    DataGenerator dataGenerator{};
+
+    std::atomic<unsigned long long> dataCounter{0};
+
+    std::atomic_bool runProducer{ true };
+
+    auto producerRoutine =
+        [queue = std::ref(queue), ok = std::ref(ok), run = std::ref(runProducer), dataGenerator = std::ref(dataGenerator)]()
+    {
+        Producer<QueueT> producer(queue, ok, run, dataGenerator);
+        producer.run();
+    };
+
+    auto consumerRoutine =
+        [queue = std::ref(queue), dataCounter = std::ref(dataCounter)]()
+    {
+        ClosingConsumer<QueueT, DataT> consumer(queue, dataCounter);
+        consumer.run();
+    };
+
+    std::vector<std::thread> producerThreads{};
+    std::vector<std::thread> consumerThreads{};
+
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+        producerThreads.emplace_back(producerRoutine);
+    }
+
+    for (size_t i = 0; i < numberOfConsumers; ++i) {
+        consumerThreads.emplace_back(consumerRoutine);
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds{ 1 });
+    runProducer = false;
+
+    for (size_t i = 0; i < producerThreads.size(); ++i) {
+        producerThreads.at(i).join();
+    }
+
+    auto closeStart = std::chrono::steady_clock::now();
+
+    queue.close(); // The consumers drain the queue and stop, no external flag needed.
+
+    for (size_t i = 0; i < consumerThreads.size(); ++i) {
+        consumerThreads.at(i).join();
+    }
+
+    auto shutdown = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - closeStart);
+
+    bool okSnap = ok.load(std::memory_order_consume);
+    bool hasDataSnap = queue.hasData();
+    bool pushSnap = queue.push(nullptr);
+
+    std::cout << "Count of poped data: " << dataCounter.load(std::memory_order_acquire) << std::endl;
+
+    std::cout << "okSnap: " << okSnap << "\n"
+              << "hasDataSnap: " << hasDataSnap << "\n"
+              << "pushSnap: " << pushSnap << "\n"
+              << "shutdown (ms): " << shutdown.count() << std::endl;
+
+    return okSnap && // Verify we poped all the data in the queue
+        !hasDataSnap && // We should have no pending data in the queue.
+        !pushSnap; // A closed queue accepts no more data.
+}
+
+bool RunPopUntilTimeoutTest() {
+    using QueueT = LockFreeQueue<int, 10>;
+
+    QueueT queue{ 2 };
+    int data{};
+
+    auto start = std::chrono::steady_clock::now();
+    QueueStatus status = queue.popUntil(data, start + std::chrono::milliseconds{ 50 });
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    std::thread producerThread{ [&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        queue.push(7);
+    } };
+
+    QueueStatus wokenStatus = queue.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 10 });
+
+    producerThread.join();
+
+    return status == QueueStatus::Timeout &&
+           waited >= std::chrono::milliseconds{ 50 } &&
+           wokenStatus == QueueStatus::Success && data == 7;
+}
+
+template<typename QueueT>
+bool RunPopUntilPingPongTest(const char* name) {
+
+    const int numberOfRounds{ 20000 };
+
+    QueueT ping{ 2 };
+    QueueT pong{ 2 };
+    std::atomic<bool> timedOut{ false };
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Every popUntil starts while the other thread may be pushing, so a
+    // push which misses the waiter shows up as a timeout.
+    std::thread echo{ [&]() {
+        int data{};
+        for (int round = 0; round < numberOfRounds; ++round) {
+            if (ping.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 5 }) != QueueStatus::Success) {
+                timedOut = true;
+                return;
+            }
+            pong.push(data);
+        }
+    } };
+
+    int data{};
+    for (int round = 0; round < numberOfRounds && !timedOut; ++round) {
+        ping.push(round);
+        if (pong.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 5 }) != QueueStatus::Success ||
+            data != round) {
+            timedOut = true;
+        }
+    }
+
+    echo.join();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << name << " ping-pong of " << numberOfRounds << " rounds took " << elapsed.count() << "ms" << std::endl;
+
+    return !timedOut;
+}
+
 int main() {
     std::cout << "Test Started!" << std::endl;
 
+    if (!RunPopUntilTimeoutTest() ||
+        !RunPopUntilPingPongTest<LockFreeQueue<int, 10>>("MPMC") ||
+        !RunPopUntilPingPongTest<LockFreeQueue<int, 10, Producers::Single, Consumers::Single>>("SPSC")) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    for (int i = 0; i < 4; ++i){
+        if (!RunLockFreeQueueCloseTest()) {
+
+            std::cout << "Test Failed!" << std::endl;
+            return 1;
+        }
+    }
+
     for (int i = 0; i < 2*12; ++i){
         if (!RunLockFreeQueueTest()) {
 
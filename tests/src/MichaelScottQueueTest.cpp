@@ -0,0 +1,105 @@
+#include <MichaelScottQueue.h>
+#include <QueueTest.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool RunBurstTest() {
+
+    MichaelScottQueue<std::string> queue{};
+
+    // Far more than any ring of the other tests holds, and in two bursts so the second reuses nodes.
+    for (size_t burst = 0; burst < 2; ++burst) {
+
+        for (size_t i = 0; i < 100000; ++i) {
+            queue.push(std::to_string(i));
+        }
+
+        std::string data{};
+        for (size_t i = 0; i < 100000; ++i) {
+            if (!queue.pop(data) || data != std::to_string(i)) {
+                std::cout << "Burst " << burst << " lost the order at " << i << std::endl;
+                return false;
+            }
+        }
+
+        if (queue.pop(data) || queue.hasData()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RunThreadedTest() {
+
+    MichaelScottQueue<unsigned long long> queue{};
+
+    return runProducersConsumers(queue, 4, 4, 200000);
+}
+
+bool RunQueueLifetimeTest() {
+
+    const size_t numberOfThreads{ 4 };
+    const size_t rounds{ 20 };
+
+    // The threads outlive the queues they used, and every new queue has room for exactly the same threads.
+    auto queue = std::make_unique<MichaelScottQueue<unsigned long long>>(numberOfThreads);
+
+    std::atomic<size_t> started{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    std::atomic<size_t> failures{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (size_t thread = 0; thread < numberOfThreads; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (size_t round = 1; round <= rounds; ++round) {
+
+                while (started.load(std::memory_order_acquire) != round) {
+                    std::this_thread::yield();
+                }
+
+                for (unsigned long long i = 0; i < 1000; ++i) {
+                    queue->push(thread);
+                    unsigned long long data{};
+                    if (!queue->pop(data)) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                finished.fetch_add(1, std::memory_order_acq_rel);
+            }
+        });
+    }
+
+    for (size_t round = 1; round <= rounds; ++round) {
+
+        started.store(round, std::memory_order_release);
+
+        while (finished.load(std::memory_order_acquire) != round * numberOfThreads) {
+            std::this_thread::yield();
+        }
+
+        queue = std::make_unique<MichaelScottQueue<unsigned long long>>(numberOfThreads);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return failures.load() == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunBurstTest() || !RunThreadedTest() || !RunQueueLifetimeTest()) {
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
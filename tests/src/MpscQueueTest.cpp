@@ -0,0 +1,129 @@
+#include <MpscQueue.h>
+#include <iostream>
+#include <vector>
+
+bool RunCapacityTest() {
+
+    MpscQueue<int, 4> queue{};
+
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.push(i)) {
+            std::cout << "The queue must accept bufferSize items!" << std::endl;
+            return false;
+        }
+    }
+
+    if (queue.push(4)) {
+        std::cout << "A full queue must reject data!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.pop(data) || data != i) {
+            return false;
+        }
+    }
+
+    return !queue.pop(data) && !queue.hasData() && queue.push(5) && queue.pop(data) && data == 5;
+}
+
+bool RunManyProducersTest() {
+
+    const size_t numberOfProducers{ 16 };
+    const unsigned long long itemsPerProducer{ 50000 };
+
+    // The producer id is kept in the high bits so the consumer can check the per-producer order.
+    MpscQueue<unsigned long long, 128> queue{};
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        producerThreads.emplace_back([&queue, producer, itemsPerProducer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!queue.push((static_cast<unsigned long long>(producer) << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<unsigned long long> lastSeen(numberOfProducers, 0);
+    bool inOrder{ true };
+
+    for (unsigned long long count = 0; count < numberOfProducers * itemsPerProducer; ) {
+        unsigned long long data{};
+        if (queue.pop(data)) {
+            size_t producer = data >> 32;
+            unsigned long long value = data & 0xFFFFFFFF;
+            if (value != lastSeen.at(producer) + 1) {
+                inOrder = false;
+            }
+            lastSeen.at(producer) = value;
+            ++count;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+
+    return inOrder && !queue.hasData();
+}
+
+bool RunRaceForLastSpaceTest() {
+
+    const size_t numberOfProducers{ 8 };
+
+    MpscQueue<int, 4> queue{};
+
+    for (size_t round = 0; round < 200; ++round) {
+
+        std::atomic<size_t> pushed{ 0 };
+
+        std::vector<std::thread> producerThreads{};
+        for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+            producerThreads.emplace_back([&queue, &pushed]() {
+                for (int i = 0; i < 100; ++i) {
+                    if (queue.push(i)) { // A full queue must fail straight away, nobody pops meanwhile.
+                        pushed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : producerThreads) {
+            thread.join();
+        }
+
+        int data{};
+        size_t poped{ 0 };
+        while (queue.pop(data)) {
+            ++poped;
+        }
+
+        if (pushed.load() != 4 || poped != 4) {
+            std::cout << "Round " << round << " pushed " << pushed.load() << " poped " << poped << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunCapacityTest() ||
+        !RunManyProducersTest() ||
+        !RunRaceForLastSpaceTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
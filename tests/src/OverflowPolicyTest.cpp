@@ -0,0 +1,197 @@
+#include <LockFreeQueue.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Queue = LockFreeQueue<unsigned long long, 8>; // MPMC, holds 7 items.
+
+bool Fill(Queue& queue) {
+    for (unsigned long long i = 0; i < 7; ++i) {
+        if (queue.offer(i) != QueueStatus::Success) {
+            return false;
+        }
+    }
+    return !queue.push(7);
+}
+
+bool RunDropTest() {
+
+    Queue queue{ 1 };
+    unsigned long long data{};
+
+    if (!Fill(queue) || queue.offer(7) != QueueStatus::Full || queue.overflowStatistics().rejected != 1) {
+        std::cout << "Reject failed" << std::endl;
+        return false;
+    }
+
+    queue.setOverflowPolicy({ OverflowAction::DropNewest });
+    if (queue.offer(7) != QueueStatus::Dropped || queue.overflowStatistics().droppedNewest != 1 || !queue.pop(data) || data != 0) {
+        std::cout << "DropNewest failed" << std::endl;
+        return false;
+    }
+
+    queue.setOverflowPolicy({ OverflowAction::DropOldest });
+    for (unsigned long long i = 7; i < 10; ++i) {
+        if (queue.offer(i) != QueueStatus::Success) {
+            return false;
+        }
+    }
+
+    for (unsigned long long expected = 3; expected < 10; ++expected) { // 1 and 2 made room for 8 and 9.
+        if (!queue.pop(data) || data != expected) {
+            std::cout << "DropOldest failed at " << expected << std::endl;
+            return false;
+        }
+    }
+
+    OverflowStatistics statistics = queue.overflowStatistics();
+    if (statistics.droppedOldest != 2 || statistics.rejected != 1 || statistics.droppedNewest != 1 || queue.hasData()) {
+        return false;
+    }
+
+    queue.close();
+
+    return queue.offer(1) == QueueStatus::Closed;
+}
+
+bool RunSingleConsumerDropOldestTest() {
+
+    LockFreeQueue<unsigned long long, 4, Producers::Multi, Consumers::Single> queue{ 1 };
+    queue.setOverflowPolicy({ OverflowAction::DropOldest });
+
+    for (unsigned long long i = 0; i < 6; ++i) {
+        queue.offer(i);
+    }
+
+    unsigned long long data{};
+
+    return queue.overflowStatistics().droppedNewest == 2 && queue.pop(data) && data == 0; // A producer can not pop, the newest are dropped.
+}
+
+bool RunEarlyDropTest() {
+
+    LockFreeQueue<unsigned long long, 65> queue{ 1 }; // Holds 64 items.
+    queue.setOverflowPolicy({ OverflowAction::EarlyDrop, std::chrono::nanoseconds{ 0 }, 0.5 });
+
+    size_t pushed{ 0 };
+    size_t dropped{ 0 };
+
+    for (unsigned long long i = 0; i < 10000; ++i) {
+        QueueStatus status = queue.offer(i);
+        pushed += status == QueueStatus::Success;
+        dropped += status == QueueStatus::Dropped;
+
+        if (i < 32 && status != QueueStatus::Success) {
+            std::cout << "Dropped below the threshold at " << i << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "EarlyDrop pushed " << pushed << " dropped " << dropped << std::endl;
+
+    return pushed <= 64 && pushed > 32 && pushed + dropped == 10000 && queue.overflowStatistics().droppedEarly == dropped;
+}
+
+bool RunBlockTest() {
+
+    Queue queue{ 2 };
+    queue.setOverflowPolicy({ OverflowAction::Block, std::chrono::milliseconds{ 20 } });
+
+    if (!Fill(queue)) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (queue.offer(7) != QueueStatus::Timeout || std::chrono::steady_clock::now() - start < std::chrono::milliseconds{ 20 }) {
+        std::cout << "Block did not wait for the timeout" << std::endl;
+        return false;
+    }
+
+    queue.setOverflowPolicy({ OverflowAction::Block, std::chrono::seconds{ 10 } });
+
+    std::thread consumer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        unsigned long long data{};
+        queue.pop(data);
+    });
+
+    start = std::chrono::steady_clock::now();
+    bool woken = queue.offer(7) == QueueStatus::Success && std::chrono::steady_clock::now() - start < std::chrono::seconds{ 5 };
+    consumer.join();
+
+    std::thread closer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        queue.close();
+    });
+
+    bool closed = queue.offer(8) == QueueStatus::Closed;
+    closer.join();
+
+    OverflowStatistics statistics = queue.overflowStatistics();
+
+    return woken && closed && statistics.blocked == 3 && statistics.timedOut == 1;
+}
+
+template<typename QueueT>
+bool RunThreadedBlockTest(const char* name, size_t numberOfProducers, size_t numberOfConsumers) {
+
+    const unsigned long long itemsPerProducer{ 50000 };
+
+    QueueT queue{ numberOfProducers + numberOfConsumers };
+    queue.setOverflowPolicy({ OverflowAction::Block, std::chrono::seconds{ 30 } });
+
+    std::atomic<bool> allPushed{ true };
+
+    std::vector<std::thread> threads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        threads.emplace_back([&, producer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                if (queue.offer(producer * itemsPerProducer + i) != QueueStatus::Success) {
+                    allPushed.store(false, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    std::atomic<unsigned long long> remaining{ numberOfProducers * itemsPerProducer };
+    std::atomic<unsigned long long> sum{ 0 };
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            unsigned long long data{};
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                if (queue.popUntil(data, std::chrono::steady_clock::now() + std::chrono::milliseconds{ 10 }) == QueueStatus::Success) {
+                    sum.fetch_add(data, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long totalItems = numberOfProducers * itemsPerProducer;
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+
+    std::cout << name << " Sum: " << sum.load() << " Expected: " << expectedSum
+              << " Blocked: " << queue.overflowStatistics().blocked << std::endl;
+
+    return allPushed.load() && sum.load() == expectedSum && queue.overflowStatistics().timedOut == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunDropTest() || !RunSingleConsumerDropOldestTest() || !RunEarlyDropTest() || !RunBlockTest() ||
+        !RunThreadedBlockTest<LockFreeQueue<unsigned long long, 16>>("MPMC", 4, 4) ||
+        !RunThreadedBlockTest<LockFreeQueue<unsigned long long, 16, Producers::Single, Consumers::Single>>("SPSC", 1, 1)) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
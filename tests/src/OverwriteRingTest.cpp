@@ -0,0 +1,246 @@
+#include <OverwriteRing.h>
+#include <QueueTest.h>
+#include <QueueTopology.h>
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <sys/time.h>
+#include <thread>
+#include <vector>
+
+static_assert(QueueEngine<OverwriteRing<unsigned long long, 64>>);
+
+struct Sample { // Trivially copyable but not trivial, like most records.
+    unsigned long long value{ 0 };
+    unsigned long long check{ ~0ULL }; // ~value, a torn copy breaks the pair
+    unsigned char tag[12]{};
+};
+
+bool RunSingleThreadTest() {
+
+    OverwriteRing<unsigned long long, 8> queue{};
+
+    for (unsigned long long i = 0; i < 20; ++i) {
+        if (!queue.push(i)) { // Never fails on a full ring.
+            return false;
+        }
+    }
+
+    unsigned long long data{};
+    size_t lost{ 0 };
+
+    if (!queue.pop(data, lost) || data != 12 || lost != 12) { // The newest 8 are kept.
+        std::cout << "Poped " << data << " after losing " << lost << std::endl;
+        return false;
+    }
+
+    for (unsigned long long expected = 13; expected < 20; ++expected) {
+        if (!queue.pop(data, lost) || data != expected || lost != 0) {
+            return false;
+        }
+    }
+
+    if (queue.hasData() || queue.pop(data) || queue.dropped() != 12) {
+        return false;
+    }
+
+    queue.push(20); // An empty ring starts over without loss.
+    if (!queue.pop(data, lost) || data != 20 || lost != 0) {
+        return false;
+    }
+
+    queue.close();
+
+    return !queue.push(1) && queue.isClosed() && queue.hasSpace();
+}
+
+bool RunPushAfterCloseTest() {
+
+    OverwriteRing<unsigned long long, 8> queue{};
+
+    for (unsigned long long i = 0; i < 16; ++i) {
+        queue.push(i);
+    }
+
+    queue.close();
+
+    for (unsigned long long i = 0; i < 100; ++i) {
+        if (queue.push(i)) { // Rejected pushes must not claim tickets.
+            return false;
+        }
+    }
+
+    unsigned long long data{};
+    unsigned long long expected{ 8 };
+    while (queue.pop(data)) {
+        if (data != expected++) {
+            return false;
+        }
+    }
+
+    std::cout << "Closed Poped: " << expected - 8 << " Dropped: " << queue.dropped() << std::endl;
+
+    return expected == 16 && queue.dropped() == 8 && !queue.hasData();
+}
+
+bool RunThreadedTest(size_t numberOfProducers, size_t numberOfConsumers) {
+
+    const unsigned long long itemsPerProducer{ 100000 };
+
+    OverwriteRing<Sample, 64> queue{};
+
+    std::atomic<size_t> producing{ numberOfProducers };
+    std::atomic<unsigned long long> poped{ 0 };
+    std::atomic<bool> intact{ true };
+    std::atomic<bool> inOrder{ true };
+
+    std::vector<std::thread> threads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        threads.emplace_back([&, producer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                Sample sample{ producer * itemsPerProducer + i, ~(producer * itemsPerProducer + i), {} };
+                if (!queue.push(sample)) {
+                    intact.store(false, std::memory_order_relaxed);
+                }
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        threads.emplace_back([&]() {
+            ProducerOrder order{ numberOfProducers, itemsPerProducer };
+            Sample sample{};
+            while (true) {
+                bool done = producing.load(std::memory_order_acquire) == 0;
+                if (!queue.pop(sample)) {
+                    if (done && !queue.hasData()) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (sample.check != ~sample.value) {
+                    intact.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (!order.check(sample.value)) {
+                    inOrder.store(false, std::memory_order_relaxed);
+                }
+
+                poped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long totalItems = numberOfProducers * itemsPerProducer;
+
+    std::cout << numberOfProducers << "x" << numberOfConsumers << " Poped: " << poped.load()
+              << " Dropped: " << queue.dropped() << " Total: " << totalItems << std::endl;
+
+    return intact.load() && inOrder.load() && poped.load() + queue.dropped() == totalItems;
+}
+
+struct Frame { // Large enough for a timer to interrupt its copy.
+    unsigned long long words[1 << 13]{};
+};
+
+using FrameRing = OverwriteRing<Frame, 4>;
+
+FrameRing* frameRing{ nullptr };
+Frame* nextFrame{ nullptr };
+unsigned long long framesPushed{ 0 };
+volatile std::sig_atomic_t inPop{ 0 };
+volatile std::sig_atomic_t overwrites{ 0 };
+
+void pushFrames(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        ++framesPushed;
+        std::fill(std::begin(nextFrame->words), std::end(nextFrame->words), framesPushed);
+        frameRing->push(*nextFrame);
+    }
+}
+
+void overwriteRing(int) {
+    if (inPop) { // Lap the ring while the interrupted pop is copying a frame.
+        pushFrames(8);
+        overwrites = overwrites + 1;
+    }
+}
+
+bool RunOverwriteMidCopyTest() {
+
+    const std::sig_atomic_t numberOfOverwrites{ 100 };
+
+    auto ring = std::make_unique<FrameRing>();
+    auto frame = std::make_unique<Frame>();
+    auto poped = std::make_unique<Frame>();
+    frameRing = ring.get();
+    nextFrame = frame.get();
+
+    // The profiling timer only runs with the CPU time of the process, so it
+    // fires while this thread copies, and the handler overwrites the frame
+    // the pop is reading. Any torn copy has words of two frames.
+    std::signal(SIGPROF, overwriteRing);
+    itimerval period{ { 0, 1000 }, { 0, 1000 } };
+    setitimer(ITIMER_PROF, &period, nullptr);
+
+    bool intact{ true };
+    unsigned long long popedFrames{ 0 };
+    unsigned long long last{ 0 };
+
+    while (overwrites < numberOfOverwrites) {
+
+        inPop = 1;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        bool hasData = frameRing->pop(*poped);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        inPop = 0;
+
+        if (!hasData) {
+            pushFrames(4); // Outside a pop, the handler leaves these alone.
+            continue;
+        }
+
+        const auto& words = poped->words;
+        if (!std::all_of(std::begin(words), std::end(words), [&](unsigned long long word) { return word == words[0]; }) || words[0] <= last) {
+            intact = false;
+        }
+        last = words[0];
+        ++popedFrames;
+    }
+
+    itimerval stop{};
+    setitimer(ITIMER_PROF, &stop, nullptr);
+    std::signal(SIGPROF, SIG_DFL);
+
+    while (frameRing->pop(*poped)) {
+        ++popedFrames;
+    }
+
+    std::cout << "Mid-copy Poped: " << popedFrames << " Dropped: " << frameRing->dropped() << " Total: " << framesPushed << std::endl;
+
+    return intact && popedFrames + frameRing->dropped() == framesPushed;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunSingleThreadTest() || !RunPushAfterCloseTest() ||
+        !RunThreadedTest(1, 1) || !RunThreadedTest(4, 4) || !RunThreadedTest(8, 2) ||
+        !RunOverwriteMidCopyTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
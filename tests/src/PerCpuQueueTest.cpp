@@ -0,0 +1,51 @@
+#include <PerCpuQueue.h>
+#include <QueueTest.h>
+#include <QueueTopology.h>
+#include <iostream>
+#include <thread>
+
+static_assert(QueueEngine<PerCpuQueue<unsigned long long, 64>>);
+
+bool RunSingleThreadTest() {
+
+    PerCpuQueue<unsigned long long, 64> queue{ 1 }; // One shard, so one FIFO.
+
+    return runFifoRounds(queue, 64);
+}
+
+bool RunCpuTest() {
+
+    PerCpuQueue<unsigned long long, 64> queue{}; // One shard per configured CPU.
+
+    std::cout << "Running on CPU " << currentCpu() << " of " << queue.numberOfShards() << std::endl;
+
+    return queue.numberOfShards() >= 1 && queue.push(1) && queue.hasData();
+}
+
+bool RunThreadedTest(size_t numberOfShards, size_t numberOfProducers, size_t numberOfConsumers) {
+
+    PerCpuQueue<unsigned long long, 64> queue{ numberOfShards };
+
+    std::cout << numberOfShards << " shards ";
+
+    // A producer migrated to another CPU pushes to another shard, so there is no order to check.
+    bool passed = runProducersConsumers(queue, numberOfProducers, numberOfConsumers, 100000, false);
+
+    queue.close();
+
+    return passed && !queue.push(1);
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunSingleThreadTest() || !RunCpuTest() ||
+        !RunThreadedTest(1, 4, 4) || !RunThreadedTest(std::thread::hardware_concurrency(), 8, 2) || !RunThreadedTest(16, 8, 8)) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <LockFreeQueue.h>
+#include <iostream>
+#include <vector>
+
+bool RunPushBulkTest() {
+
+    LockFreeQueue<int, 8> queue{ 2 }; // Holds 7 items.
+
+    std::vector<int> items{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    if (queue.pushBulk(items.data(), items.size()) != 7) {
+        std::cout << "pushBulk must fill the queue and stop!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 7; ++i) {
+        if (!queue.pop(data) || data != i) {
+            std::cout << "pushBulk must keep the order!" << std::endl;
+            return false;
+        }
+    }
+
+    queue.close();
+
+    return !queue.pop(data) && !queue.hasData() && queue.pushBulk(items.data() + 7, 3) == 0;
+}
+
+bool RunFlushTest() {
+
+    LockFreeQueue<int, 64> queue{ 2 };
+    int data{};
+
+    {
+        auto handle = queue.producerHandle(4, std::chrono::hours{ 1 });
+
+        for (int i = 0; i < 3; ++i) {
+            handle.push(i);
+        }
+
+        if (queue.hasData() || handle.staged() != 3) {
+            std::cout << "Items must stay staged until the batch is full!" << std::endl;
+            return false;
+        }
+
+        handle.push(3);
+
+        if (handle.staged() != 0) {
+            std::cout << "A full batch must be flushed!" << std::endl;
+            return false;
+        }
+
+        handle.push(4);
+        handle.flush();
+
+        for (int i = 0; i < 5; ++i) {
+            if (!queue.pop(data) || data != i) {
+                return false;
+            }
+        }
+
+        handle.push(5); // Left for the destructor.
+    }
+
+    if (!queue.pop(data) || data != 5) {
+        std::cout << "The destructor must flush the staged items!" << std::endl;
+        return false;
+    }
+
+    auto handle = queue.producerHandle(4, std::chrono::milliseconds{ 1 });
+
+    handle.push(6);
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+
+    if (!handle.flushExpired() || !queue.pop(data) || data != 6) {
+        std::cout << "Items staged longer than maxDelay must be flushed!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+template<typename QueueT>
+bool RunManyProducersTest(const char* name) {
+
+    const size_t numberOfProducers{ 4 };
+    const unsigned long long itemsPerProducer{ 100000 };
+
+    QueueT queue{ numberOfProducers + 1 };
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        producerThreads.emplace_back([&queue, producer, itemsPerProducer]() {
+            auto handle = queue.producerHandle(16, std::chrono::microseconds{ 100 });
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!handle.push((static_cast<unsigned long long>(producer) << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }); // The handle flushes the last batch on its way out.
+    }
+
+    std::vector<unsigned long long> lastSeen(numberOfProducers, 0);
+    bool inOrder{ true };
+
+    for (unsigned long long count = 0; count < numberOfProducers * itemsPerProducer; ) {
+        unsigned long long data{};
+        if (queue.pop(data)) {
+            size_t producer = data >> 32;
+            unsigned long long value = data & 0xFFFFFFFF;
+            if (value != lastSeen.at(producer) + 1) {
+                inOrder = false;
+            }
+            lastSeen.at(producer) = value;
+            ++count;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+
+    std::cout << name << " In Order: " << inOrder << std::endl;
+
+    return inOrder && !queue.hasData();
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunPushBulkTest() ||
+        !RunFlushTest() ||
+        !RunManyProducersTest<LockFreeQueue<unsigned long long, 64>>("MPMC") ||
+        !RunManyProducersTest<LockFreeQueue<unsigned long long, 64, Producers::Multi, Consumers::Single>>("MPSC")) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <LockFreeQueue.h>
+#include <QueueSet.h>
+#include <iostream>
+#include <vector>
+#include <memory>
+
+using QueueT = LockFreeQueue<unsigned long long, 64>;
+
+bool RunWeightedOrderTest() {
+
+    QueueT first{ 2 };
+    QueueT second{ 2 };
+
+    QueueSet<QueueT> queueSet{};
+    queueSet.add(first, 2);
+    queueSet.add(second, 1);
+
+    for (unsigned long long i = 0; i < 6; ++i) {
+        first.push(100 + i);
+        second.push(200 + i);
+    }
+
+    // The first queue gives two items for every item of the second one,
+    // until it runs out of data.
+    std::vector<unsigned long long> expected{ 100, 101, 200, 102, 103, 201, 104, 105, 202, 203, 204, 205 };
+
+    for (auto value : expected) {
+        unsigned long long data{};
+        if (!queueSet.pop(data) || data != value) {
+            std::cout << "Unexpected order, expected " << value << " got " << data << std::endl;
+            return false;
+        }
+    }
+
+    unsigned long long data{};
+    return !queueSet.pop(data);
+}
+
+bool RunSelectTest() {
+
+    const size_t numberOfQueues{ 4 };
+    const unsigned long long itemsPerQueue{ 20000 };
+
+    std::vector<std::unique_ptr<QueueT>> queues{};
+    QueueSet<QueueT> queueSet{};
+
+    for (size_t i = 0; i < numberOfQueues; ++i) {
+        queues.push_back(std::make_unique<QueueT>(numberOfQueues + 1));
+        queueSet.add(*queues.back());
+    }
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t i = 0; i < numberOfQueues; ++i) {
+        producerThreads.emplace_back([&queue = *queues.at(i), itemsPerQueue]() {
+            for (unsigned long long value = 1; value <= itemsPerQueue; ++value) {
+                while (!queue.push(value)) {
+                    std::this_thread::yield();
+                }
+                if (value % 1000 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 }); // Let the consumer go to sleep.
+                }
+            }
+        });
+    }
+
+    unsigned long long sum{ 0 };
+    for (unsigned long long i = 0; i < numberOfQueues * itemsPerQueue; ++i) {
+        unsigned long long data{};
+        queueSet.select(data);
+        sum += data;
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+
+    std::cout << "Select Sum: " << sum << std::endl;
+
+    return sum == numberOfQueues * itemsPerQueue * (itemsPerQueue + 1) / 2;
+}
+
+bool RunSelectUntilTest() {
+
+    QueueT queue{ 2 };
+    QueueSet<QueueT> queueSet{};
+    queueSet.add(queue);
+
+    unsigned long long data{};
+
+    auto start = std::chrono::steady_clock::now();
+    if (queueSet.selectUntil(data, start + std::chrono::milliseconds{ 50 }) != QueueStatus::Timeout) {
+        std::cout << "Poped from an empty set!" << std::endl;
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds{ 50 }) {
+        std::cout << "Returned before the deadline!" << std::endl;
+        return false;
+    }
+
+    std::thread producerThread{ [&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        queue.push(42);
+    } };
+
+    QueueStatus status = queueSet.selectUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 10 });
+
+    producerThread.join();
+
+    return status == QueueStatus::Success && data == 42;
+}
+
+bool RunCloseTest() {
+
+    QueueT first{ 2 };
+    QueueT second{ 2 };
+
+    QueueSet<QueueT> queueSet{};
+    queueSet.add(first);
+    queueSet.add(second);
+
+    first.push(1);
+    first.close();
+
+    unsigned long long data{};
+    if (queueSet.select(data) != QueueStatus::Success || data != 1) {
+        std::cout << "Data left in a closed queue must be poped!" << std::endl;
+        return false;
+    }
+
+    std::thread closeThread{ [&second]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        second.close();
+    } };
+
+    QueueStatus status = queueSet.select(data); // Blocks until the last queue is closed.
+
+    closeThread.join();
+
+    return status == QueueStatus::Closed;
+}
+
+bool RunEmptySetTest() {
+
+    QueueSet<QueueT> queueSet{};
+
+    unsigned long long data{};
+    QueueStatus status = queueSet.select(data); // Nothing can ever be pushed, it must not block.
+    QueueStatus untilStatus = queueSet.selectUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 10 });
+
+    return status == QueueStatus::Closed && untilStatus == QueueStatus::Closed;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunWeightedOrderTest() ||
+        !RunSelectTest() ||
+        !RunSelectUntilTest() ||
+        !RunCloseTest() ||
+        !RunEmptySetTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <LockFreeQueue.h>
+#include <CoroutineExecutor.h>
+#include <iostream>
+#include <vector>
+
+template<typename QueueT>
+constexpr size_t maxProducers() {
+    return std::is_same_v<typename QueueT::ProducerType, Producers::Single> ? 1 : 4;
+}
+
+template<typename QueueT>
+constexpr size_t maxConsumers() {
+    return std::is_same_v<typename QueueT::ConsumerType, Consumers::Single> ? 1 : 4;
+}
+
+template<typename QueueT>
+bool RunThreadedTest(const char* name) {
+
+    const size_t numberOfProducers{ maxProducers<QueueT>() };
+    const size_t numberOfConsumers{ maxConsumers<QueueT>() };
+    const unsigned long long itemsPerProducer{ 100000 };
+
+    QueueT queue{ numberOfProducers + numberOfConsumers };
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        producerThreads.emplace_back([&queue, producer, itemsPerProducer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!queue.push(producer * itemsPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+            if constexpr (std::is_same_v<typename QueueT::ProducerType, Producers::Single>) {
+                queue.close(); // A single producer closes the queue itself.
+            }
+        });
+    }
+
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<bool> closedSeen{ true };
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&queue, &sum, &closedSeen]() {
+            unsigned long long data{};
+            while (true) {
+                QueueStatus status = queue.popUntil(data, std::chrono::steady_clock::now() + std::chrono::seconds{ 30 });
+                if (status == QueueStatus::Success) {
+                    sum.fetch_add(data, std::memory_order_relaxed);
+                    continue;
+                }
+                if (status != QueueStatus::Closed) {
+                    closedSeen.store(false, std::memory_order_relaxed);
+                }
+                break;
+            }
+        });
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+
+    queue.close();
+
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    unsigned long long totalItems = numberOfProducers * itemsPerProducer;
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+
+    std::cout << name << " Sum: " << sum.load() << " Expected: " << expectedSum << std::endl;
+
+    return sum.load() == expectedSum && closedSeen.load() && !queue.push(1) && !queue.hasData();
+}
+
+template<typename QueueT>
+DetachedTask produce(QueueT& queue, CoroutineExecutor& executor,
+                     unsigned long long first, unsigned long long count,
+                     std::atomic<size_t>& finished) {
+    co_await executor.schedule();
+
+    for (unsigned long long i = 0; i < count; ++i) {
+        co_await queue.asyncPush(executor, first + i);
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+template<typename QueueT>
+DetachedTask consume(QueueT& queue, CoroutineExecutor& executor,
+                     unsigned long long count,
+                     std::atomic<unsigned long long>& sum,
+                     std::atomic<size_t>& finished) {
+    co_await executor.schedule();
+
+    for (unsigned long long i = 0; i < count; ++i) {
+        std::optional<unsigned long long> data = co_await queue.asyncPop(executor);
+        sum.fetch_add(*data, std::memory_order_relaxed);
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+template<typename QueueT>
+bool RunAsyncTest(const char* name) {
+
+    const size_t numberOfProducers{ maxProducers<QueueT>() };
+    const size_t numberOfConsumers{ maxConsumers<QueueT>() };
+    const unsigned long long totalItems{ 20000 };
+
+    QueueT queue{ 4 };
+    CoroutineExecutor executor{};
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<size_t> finished{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&executor]() { executor.run(); });
+    }
+
+    for (size_t i = 0; i < numberOfConsumers; ++i) {
+        consume(queue, executor, totalItems / numberOfConsumers, sum, finished);
+    }
+
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+        produce(queue, executor, 1 + i * (totalItems / numberOfProducers), totalItems / numberOfProducers, finished);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 60 };
+    while (finished.load(std::memory_order_acquire) != numberOfProducers + numberOfConsumers &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    bool finishedSnap = finished.load(std::memory_order_acquire) == numberOfProducers + numberOfConsumers;
+
+    executor.stop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long expectedSum = totalItems * (totalItems + 1) / 2;
+
+    std::cout << name << " Async Sum: " << sum.load() << " Expected: " << expectedSum << std::endl;
+
+    return finishedSnap && sum.load() == expectedSum && !queue.hasData();
+}
+
+template<typename QueueT>
+bool RunTopologyTest(const char* name) {
+    return RunThreadedTest<QueueT>(name) && RunAsyncTest<QueueT>(name);
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunTopologyTest<LockFreeQueue<unsigned long long, 64>>("MPMC") ||
+        !RunTopologyTest<LockFreeQueue<unsigned long long, 64, Producers::Multi, Consumers::Single>>("MPSC") ||
+        !RunTopologyTest<LockFreeQueue<unsigned long long, 64, Producers::Single, Consumers::Multi>>("SPMC") ||
+        !RunTopologyTest<LockFreeQueue<unsigned long long, 64, Producers::Single, Consumers::Single>>("SPSC")) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <LockFreeQueue.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template<typename SourceT, typename TargetT, typename MakeT>
+bool RunDrainTest(const char* name, MakeT make) {
+
+    SourceT source{ 2 };
+    TargetT target{ 2 };
+
+    typename SourceT::ItemType data{};
+
+    for (int i = 0; i < 10; ++i) { // Move the indexes so the runs wrap around the end of the buffers.
+        source.push(make(-1));
+        source.pop(data);
+    }
+    for (int i = 0; i < 5; ++i) {
+        target.push(make(-1));
+        target.pop(data);
+    }
+
+    for (int i = 0; i < 14; ++i) {
+        source.push(make(i));
+    }
+
+    if (source.drainInto(target, 4) != 4) {
+        std::cout << name << ": drainInto must stop at max!" << std::endl;
+        return false;
+    }
+
+    size_t moved = source.drainInto(target, 100);
+
+    for (int i = 0; i < 14; ++i) {
+        if (!target.pop(data) || data != make(i)) {
+            std::cout << name << ": drainInto must keep the order!" << std::endl;
+            return false;
+        }
+    }
+
+    return moved == 10 && !source.hasData() && !target.hasData() && source.drainInto(target, 100) == 0;
+}
+
+template<typename SourceT>
+bool RunDrainIntoFullTest(const char* name) {
+
+    SourceT source{ 2 };
+    LockFreeQueue<int, 8> target{ 2 }; // Holds 7 items.
+
+    for (int i = 0; i < 12; ++i) {
+        source.push(i);
+    }
+
+    if (source.drainInto(target, 100) != 7 || source.drainInto(target, 100) != 0) {
+        std::cout << name << ": drainInto must stop once the other queue is full!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 7; ++i) {
+        if (!target.pop(data) || data != i) {
+            return false;
+        }
+    }
+    for (int i = 7; i < 12; ++i) {
+        if (!source.pop(data) || data != i) {
+            std::cout << name << ": the data left behind must keep its order!" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RunConcurrentDrainTest() {
+
+    const unsigned long long numberOfItems{ 200000 };
+
+    LockFreeQueue<unsigned long long, 256> source{ 3 };
+    LockFreeQueue<unsigned long long, 64> target{ 3 };
+
+    std::atomic<bool> done{ false };
+
+    std::thread producerThread{ [&source, numberOfItems]() {
+        for (unsigned long long i = 1; i <= numberOfItems; ++i) {
+            while (!source.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    std::thread rebalanceThread{ [&source, &target, &done]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            if (source.drainInto(target, 32) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    unsigned long long sum{ 0 };
+    for (unsigned long long count = 0; count < numberOfItems; ) {
+        unsigned long long data{};
+        if (target.pop(data)) {
+            sum += data;
+            ++count;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    done.store(true, std::memory_order_relaxed);
+
+    producerThread.join();
+    rebalanceThread.join();
+
+    std::cout << "Concurrent Drain Sum: " << sum << std::endl;
+
+    return sum == numberOfItems * (numberOfItems + 1) / 2;
+}
+
+template<typename QueueT>
+bool RunSwapTest(const char* name) {
+
+    QueueT first{ 2 };
+    QueueT second{ 2 };
+
+    for (int i = 0; i < 3; ++i) {
+        first.push(i);
+    }
+    second.push(100);
+    second.close();
+
+    first.swapContents(second);
+
+    int data{};
+    if (!first.pop(data) || data != 100 || first.pop(data) || first.isClosed()) {
+        std::cout << name << ": the data must be swapped, not the closed state!" << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        if (!second.pop(data) || data != i) {
+            return false;
+        }
+    }
+
+    return second.isClosed() && !second.hasData() && first.push(4) && first.pop(data) && data == 4;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    auto makeInt = [](int i) { return i; };
+    auto makeString = [](int i) { return std::to_string(i); };
+
+    if (!RunDrainTest<LockFreeQueue<int, 16>, LockFreeQueue<int, 16>>("MPMC int", makeInt) ||
+        !RunDrainTest<LockFreeQueue<std::string, 16>, LockFreeQueue<std::string, 32>>("MPMC string", makeString) ||
+        !RunDrainTest<LockFreeQueue<int, 16>, LockFreeQueue<int, 16, Producers::Single, Consumers::Single>>("MPMC to SPSC", makeInt) ||
+        !RunDrainTest<LockFreeQueue<int, 16, Producers::Multi, Consumers::Single>, LockFreeQueue<int, 16>>("MPSC to MPMC", makeInt) ||
+        !RunDrainTest<LockFreeQueue<int, 16, Producers::Single, Consumers::Single>, LockFreeQueue<int, 16>>("SPSC to MPMC", makeInt) ||
+        !RunDrainIntoFullTest<LockFreeQueue<int, 16>>("MPMC") ||
+        !RunDrainIntoFullTest<LockFreeQueue<int, 16, Producers::Multi, Consumers::Single>>("MPSC") ||
+        !RunDrainIntoFullTest<LockFreeQueue<int, 16, Producers::Single, Consumers::Multi>>("SPMC") ||
+        !RunDrainIntoFullTest<LockFreeQueue<int, 16, Producers::Single, Consumers::Single>>("SPSC") ||
+        !RunConcurrentDrainTest() ||
+        !RunSwapTest<LockFreeQueue<int, 16>>("MPMC") ||
+        !RunSwapTest<LockFreeQueue<int, 16, Producers::Multi, Consumers::Single>>("MPSC") ||
+        !RunSwapTest<LockFreeQueue<int, 16, Producers::Single, Consumers::Multi>>("SPMC") ||
+        !RunSwapTest<LockFreeQueue<int, 16, Producers::Single, Consumers::Single>>("SPSC")) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <RelaxedQueue.h>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+bool RunRelaxationBoundTest() {
+
+    const size_t numberOfProducers{ 3 };
+    const size_t bufferSize{ 8 };
+
+    RelaxedQueue<unsigned long long, bufferSize> queue{ numberOfProducers };
+
+    // Producers fill their sub-rings in turn, the value is the global push order.
+    std::set<unsigned long long> pending{};
+    unsigned long long next{ 0 };
+
+    for (size_t round = 0; round < 4; ++round) {
+
+        for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+            while (queue.push(producer, next)) {
+                pending.insert(next++);
+            }
+        }
+
+        for (size_t consumer = 0; consumer < 10; ++consumer) { // Pop a few, from different first sub-rings.
+            unsigned long long data{};
+            if (!queue.pop(consumer * 7 + round, data)) {
+                return false;
+            }
+
+            size_t older = std::distance(pending.begin(), pending.find(data));
+            if (older > queue.relaxation()) {
+                std::cout << "Poped an item with " << older << " older items, the bound is " << queue.relaxation() << std::endl;
+                return false;
+            }
+            pending.erase(data);
+        }
+    }
+
+    unsigned long long data{};
+    while (queue.pop(0, data)) {
+        pending.erase(data);
+    }
+
+    return pending.empty() && !queue.hasData();
+}
+
+bool RunPerProducerOrderTest() {
+
+    const size_t numberOfProducers{ 4 };
+    const size_t numberOfConsumers{ 4 };
+    const unsigned long long itemsPerProducer{ 100000 };
+
+    RelaxedQueue<unsigned long long, 128> queue{ numberOfProducers };
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        producerThreads.emplace_back([&queue, producer, itemsPerProducer]() {
+            for (unsigned long long i = 1; i <= itemsPerProducer; ++i) {
+                while (!queue.push(producer, (static_cast<unsigned long long>(producer) << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::atomic<unsigned long long> remaining{ numberOfProducers * itemsPerProducer };
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<bool> inOrder{ true };
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&queue, &remaining, &sum, &inOrder, consumer, numberOfProducers]() {
+            std::vector<unsigned long long> lastSeen(numberOfProducers, 0);
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                unsigned long long data{};
+                if (queue.pop(consumer, data)) {
+                    size_t producer = data >> 32;
+                    unsigned long long value = data & 0xFFFFFFFF;
+                    if (value <= lastSeen.at(producer)) {
+                        inOrder.store(false, std::memory_order_relaxed); // Every consumer sees the data of a producer in order.
+                    }
+                    lastSeen.at(producer) = value;
+                    sum.fetch_add(value, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    std::cout << "Relaxed Sum: " << sum.load() << std::endl;
+
+    return inOrder.load() && sum.load() == numberOfProducers * itemsPerProducer * (itemsPerProducer + 1) / 2 && !queue.hasData();
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunRelaxationBoundTest() ||
+        !RunPerProducerOrderTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
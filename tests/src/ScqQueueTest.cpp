@@ -0,0 +1,77 @@
+#include <ScqQueue.h>
+#include <QueueTest.h>
+#include <QueueTopology.h>
+#include <iostream>
+
+static_assert(QueueEngine<ScqQueue<unsigned long long, 64>>);
+
+template<size_t bufferSize>
+bool RunSingleThreadTest() {
+
+    ScqQueue<unsigned long long, bufferSize> queue{};
+
+    return runFifoRounds(queue, bufferSize); // Many cycles of the rings.
+}
+
+template<size_t capacity>
+bool RunCatchUpTest() {
+
+    ScqRing<capacity> ring{ false };
+
+    for (size_t round = 0; round < 100; ++round) {
+
+        size_t count = round % capacity + 1;
+
+        for (size_t i = 0; i < count; ++i) {
+            ring.enqueue((round + i) % capacity);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (ring.dequeue() != (round + i) % capacity) {
+                std::cout << "Capacity " << capacity << " lost the order in round " << round << std::endl;
+                return false;
+            }
+        }
+
+        // The enqueues reset the threshold: the first dequeues take tickets past the tail and pull it along
+        // (catchUp), the next ones find the threshold spent and give up without a ticket. The next round must
+        // still find its indexes, in order.
+        for (size_t i = 0; i < 4 * capacity; ++i) {
+            if (ring.dequeue() != ScqRing<capacity>::noIndex) {
+                std::cout << "Capacity " << capacity << " found an index in an empty ring in round " << round << std::endl;
+                return false;
+            }
+        }
+
+        if (ring.hasIndexes()) {
+            return false;
+        }
+    }
+
+    ring.enqueue(0); // A spent threshold must not hide a new index.
+
+    return ring.hasIndexes() && ring.dequeue() == 0 && !ring.hasIndexes();
+}
+
+bool RunThreadedTest(size_t numberOfProducers, size_t numberOfConsumers) {
+
+    ScqQueue<unsigned long long, 64> queue{};
+
+    return runProducersConsumers(queue, numberOfProducers, numberOfConsumers, 100000);
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunSingleThreadTest<2>() || !RunSingleThreadTest<4>() || !RunSingleThreadTest<64>() ||
+        !RunCatchUpTest<2>() || !RunCatchUpTest<8>() || !RunCatchUpTest<64>() ||
+        !RunThreadedTest(1, 1) || !RunThreadedTest(4, 4) || !RunThreadedTest(8, 2) ||
+        !RunThreadedTest(1, 8) || !RunThreadedTest(2, 8)) { // Consumers racing through an empty ring.
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
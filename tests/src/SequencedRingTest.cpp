@@ -0,0 +1,149 @@
+#include <SequencedRing.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+struct Record {
+    unsigned long long raw{ 0 };
+    unsigned long long decoded{ 0 };
+    unsigned long long enriched{ 0 };
+    unsigned long long audited{ 0 };
+};
+
+using RingT = SequencedRing<Record, 256>;
+
+/** Run a stage on its own thread until it has processed totalItems spaces.
+ */
+template<typename HandlerT>
+std::thread runStage(RingT& ring, RingT::StageId stage, unsigned long long totalItems, HandlerT handler) {
+    return std::thread{ [&ring, stage, totalItems, handler]() mutable {
+        unsigned long long processed{ 0 };
+        while (processed < totalItems) {
+            size_t count = ring.process(stage, handler, 32);
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+            processed += count;
+        }
+    } };
+}
+
+bool RunPipelineTest() {
+
+    const unsigned long long totalItems{ 200000 };
+
+    RingT ring{};
+    auto decode = ring.addStage();
+    auto enrich = ring.addStage({ decode });
+    auto publish = ring.addStage({ enrich });
+
+    bool ok{ true };
+    unsigned long long expected{ 1 };
+
+    std::vector<std::thread> threads{};
+    threads.push_back(runStage(ring, decode, totalItems, [](Record& record) {
+        record.decoded = record.raw * 2;
+    }));
+    threads.push_back(runStage(ring, enrich, totalItems, [](Record& record) {
+        record.enriched = record.decoded + 1; // Only correct if decode already ran.
+    }));
+    threads.push_back(runStage(ring, publish, totalItems, [&ok, &expected](Record& record) {
+        if (record.raw != expected || record.enriched != record.raw * 2 + 1) {
+            ok = false;
+        }
+        ++expected;
+    }));
+
+    for (unsigned long long value = 1; value <= totalItems; ++value) {
+        while (!ring.publish([value](Record& record) { record = Record{ value }; })) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return ok && expected == totalItems + 1;
+}
+
+bool RunDiamondTest() {
+
+    const unsigned long long totalItems{ 200000 };
+
+    RingT ring{};
+    auto decode = ring.addStage();
+    auto enrich = ring.addStage({ decode });
+    auto audit = ring.addStage({ decode }); // Runs in parallel with enrich.
+    auto publish = ring.addStage({ enrich, audit });
+
+    bool ok{ true };
+    unsigned long long count{ 0 };
+
+    std::vector<std::thread> threads{};
+    threads.push_back(runStage(ring, decode, totalItems, [](Record& record) {
+        record.decoded = record.raw * 2;
+    }));
+    threads.push_back(runStage(ring, enrich, totalItems, [](Record& record) {
+        record.enriched = record.decoded + 1;
+    }));
+    threads.push_back(runStage(ring, audit, totalItems, [](Record& record) {
+        record.audited = record.decoded + 2;
+    }));
+    threads.push_back(runStage(ring, publish, totalItems, [&ok, &count](Record& record) {
+        if (record.enriched != record.raw * 2 + 1 || record.audited != record.raw * 2 + 2) {
+            ok = false;
+        }
+        ++count;
+    }));
+
+    for (unsigned long long value = 1; value <= totalItems; ++value) {
+        while (!ring.publish([value](Record& record) { record = Record{ value }; })) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return ok && count == totalItems && !ring.hasData(publish);
+}
+
+bool RunGatingTest() {
+
+    SequencedRing<int, 4> ring{};
+    auto first = ring.addStage();
+    auto second = ring.addStage({ first });
+
+    for (int i = 0; i < 4; ++i) {
+        ring.push(i);
+    }
+
+    if (ring.push(4) || ring.hasData(second)) {
+        std::cout << "The producer must wait for the last stage!" << std::endl;
+        return false;
+    }
+
+    if (ring.process(first, [](int&) {}) != 4 || ring.push(4)) {
+        std::cout << "Releasing a space from the first stage must not free it!" << std::endl;
+        return false;
+    }
+
+    return ring.process(second, [](int&) {}, 1) == 1 && ring.push(4);
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunGatingTest() ||
+        !RunPipelineTest() ||
+        !RunDiamondTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
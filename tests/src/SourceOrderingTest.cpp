@@ -0,0 +1,136 @@
+#include <SourceOrdering.h>
+#include <RelaxedQueue.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+bool RunCheckerTest() {
+
+    SequenceStamper stamper{ 2 };
+
+    auto first = stamper.stamp(10);
+    auto second = stamper.stamp(20);
+    auto third = stamper.stamp(30);
+
+    if (first.producerId != 2 || first.sequence != 0 || third.sequence != 2 || third.value != 30) {
+        std::cout << "The stamper must number the data of its producer!" << std::endl;
+        return false;
+    }
+
+    OrderingChecker contiguous{ OrderingCheck::Contiguous };
+    OrderingChecker monotonic{ OrderingCheck::Monotonic };
+
+    bool contiguousOk = contiguous.check(first) && !contiguous.check(third) && !contiguous.check(second);
+    bool monotonicOk = monotonic.check(first) && monotonic.check(third) && !monotonic.check(second);
+
+    if (!contiguousOk || contiguous.violations() != 2 || !monotonicOk || monotonic.violations() != 1) {
+        std::cout << "The checker must count the data seen out of order!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool RunReorderTest() {
+
+    ReorderBuffer<int> buffer{};
+    std::vector<int> released{};
+    auto collect = [&released](const SequencedItem<int>& item) { released.push_back(item.value); };
+
+    buffer.insert({ 0, 2, 102 });
+    buffer.insert({ 1, 0, 200 });
+    buffer.insert({ 0, 1, 101 });
+
+    if (buffer.release(collect) != 1 || buffer.held() != 2) {
+        std::cout << "Data must be held until its predecessors arrive!" << std::endl;
+        return false;
+    }
+
+    buffer.insert({ 0, 0, 100 });
+
+    if (buffer.release(collect) != 3 || buffer.held() != 0 || buffer.insert({ 0, 1, 101 })) {
+        return false;
+    }
+
+    return released == std::vector<int>{ 200, 100, 101, 102 };
+}
+
+bool RunRelaxedQueueTest() {
+
+    const size_t numberOfProducers{ 4 };
+    const size_t numberOfConsumers{ 3 };
+    const unsigned long long itemsPerProducer{ 50000 };
+
+    RelaxedQueue<SequencedItem<unsigned long long>, 64> queue{ numberOfProducers };
+
+    std::vector<std::thread> producerThreads{};
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+        producerThreads.emplace_back([&queue, producer, itemsPerProducer]() {
+            SequenceStamper stamper{ producer };
+            for (unsigned long long i = 0; i < itemsPerProducer; ++i) {
+                auto item = stamper.stamp(i);
+                while (!queue.push(producer, item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every consumer sees the data of a producer in order, with gaps, and
+    // forwards it to a single sink which restores the order of each producer.
+    std::atomic<unsigned long long> remaining{ numberOfProducers * itemsPerProducer };
+    std::atomic<size_t> violations{ 0 };
+    std::mutex sinkMutex{};
+    ReorderBuffer<unsigned long long> sink{};
+    OrderingChecker sinkChecker{ OrderingCheck::Contiguous };
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&, consumer]() {
+            OrderingChecker checker{ OrderingCheck::Monotonic };
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                SequencedItem<unsigned long long> item{};
+                if (queue.pop(consumer, item)) {
+                    checker.check(item);
+                    std::lock_guard<std::mutex> lock{ sinkMutex };
+                    sink.insert(item);
+                    sink.release([&sinkChecker](const SequencedItem<unsigned long long>& released) {
+                        sinkChecker.check(released);
+                    });
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            violations.fetch_add(checker.violations(), std::memory_order_relaxed);
+        });
+    }
+
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    std::cout << "Consumer violations: " << violations.load() << " Sink violations: " << sinkChecker.violations() << std::endl;
+
+    return violations.load() == 0 && sinkChecker.violations() == 0 && sink.held() == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunCheckerTest() ||
+        !RunReorderTest() ||
+        !RunRelaxedQueueTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
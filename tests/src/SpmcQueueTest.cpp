@@ -0,0 +1,142 @@
+#include <SpmcQueue.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+bool RunCapacityTest() {
+
+    SpmcQueue<int, 4> queue{};
+
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.push(i)) {
+            std::cout << "The queue must accept bufferSize items!" << std::endl;
+            return false;
+        }
+    }
+
+    if (queue.push(4)) {
+        std::cout << "A full queue must reject data!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.pop(data) || data != i) {
+            return false;
+        }
+    }
+
+    return !queue.pop(data) && !queue.hasData() && queue.push(5) && queue.pop(data) && data == 5;
+}
+
+bool RunManyConsumersTest() {
+
+    const size_t numberOfConsumers{ 16 };
+    const unsigned long long totalItems{ 500000 };
+
+    SpmcQueue<unsigned long long, 128> queue{};
+    std::atomic<unsigned long long> sum{ 0 };
+    std::atomic<unsigned long long> count{ 0 };
+    std::atomic_bool run{ true };
+
+    std::vector<std::thread> consumerThreads{};
+    for (size_t consumer = 0; consumer < numberOfConsumers; ++consumer) {
+        consumerThreads.emplace_back([&queue, &sum, &count, &run]() {
+            unsigned long long lastSeen{ 0 };
+            while (run.load(std::memory_order_relaxed) || queue.hasData()) {
+                unsigned long long data{};
+                if (queue.pop(data)) {
+                    if (data <= lastSeen) {
+                        sum.store(0); // A consumer sees the data in the order it was pushed.
+                    }
+                    lastSeen = data;
+                    sum.fetch_add(data, std::memory_order_relaxed);
+                    count.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (unsigned long long value = 1; value <= totalItems; ++value) {
+        while (!queue.push(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+    run = false;
+
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+
+    std::cout << "Count: " << count.load() << " Sum: " << sum.load() << std::endl;
+
+    return count.load() == totalItems && sum.load() == totalItems * (totalItems + 1) / 2;
+}
+
+bool RunFreeSpaceTest() {
+
+    SpmcQueue<unsigned long long, 8> queue{};
+
+    for (size_t i = 0; i <= 8; ++i) {
+        if (queue.freeSpace() != 8 - i) {
+            return false;
+        }
+        queue.push(i);
+    }
+
+    unsigned long long data{};
+    while (queue.pop(data)) {
+    }
+
+    std::atomic_bool run{ true };
+    std::atomic_bool bounded{ true };
+
+    std::thread producer{ [&queue, &run]() {
+        for (unsigned long long i = 0; i < 100000; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+        run.store(false, std::memory_order_release);
+    } };
+
+    std::thread consumer{ [&queue, &run]() {
+        unsigned long long item{};
+        while (run.load(std::memory_order_acquire) || queue.hasData()) {
+            if (!queue.pop(item)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    while (run.load(std::memory_order_acquire)) { // An observer sees the head and tail at different times.
+        if (queue.freeSpace() > 8) {
+            bounded.store(false, std::memory_order_relaxed);
+        }
+        std::this_thread::yield();
+    }
+
+    producer.join();
+    consumer.join();
+
+    return bounded.load() && queue.freeSpace() == 8;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunCapacityTest() ||
+        !RunManyConsumersTest() ||
+        !RunFreeSpaceTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <SpscQueue.h>
+#include <iostream>
+#include <thread>
+
+bool RunCapacityTest() {
+
+    SpscQueue<int, 4> queue{};
+
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.push(i)) {
+            std::cout << "The queue must accept bufferSize items!" << std::endl;
+            return false;
+        }
+    }
+
+    if (queue.push(4) || queue.hasSpace()) {
+        std::cout << "A full queue must reject data!" << std::endl;
+        return false;
+    }
+
+    int data{};
+    for (int i = 0; i < 4; ++i) {
+        if (!queue.pop(data) || data != i) {
+            return false;
+        }
+    }
+
+    if (queue.pop(data) || queue.hasData() || !queue.push(5)) {
+        return false;
+    }
+
+    queue.close();
+
+    return queue.isClosed() && !queue.push(6) && queue.pop(data) && data == 5 && !queue.pop(data);
+}
+
+bool RunOrderTest() {
+
+    const unsigned long long numberOfItems{ 1000000 };
+
+    SpscQueue<unsigned long long, 128> queue{};
+
+    std::thread producerThread{ [&queue, numberOfItems]() {
+        for (unsigned long long i = 1; i <= numberOfItems; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    bool inOrder{ true };
+
+    for (unsigned long long expected = 1; expected <= numberOfItems; ) {
+        unsigned long long data{};
+        if (queue.pop(data)) {
+            if (data != expected) {
+                inOrder = false;
+            }
+            ++expected;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    producerThread.join();
+
+    return inOrder && !queue.hasData();
+}
+
+bool RunFreeSpaceTest() {
+
+    SpscQueue<unsigned long long, 8> queue{};
+
+    for (size_t i = 0; i <= 8; ++i) {
+        if (queue.freeSpace() != 8 - i) {
+            return false;
+        }
+        queue.push(i);
+    }
+
+    unsigned long long data{};
+    while (queue.pop(data)) {
+    }
+
+    std::atomic_bool run{ true };
+    std::atomic_bool bounded{ true };
+
+    std::thread producer{ [&queue, &run]() {
+        for (unsigned long long i = 0; i < 100000; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+        run.store(false, std::memory_order_release);
+    } };
+
+    std::thread consumer{ [&queue, &run]() {
+        unsigned long long item{};
+        while (run.load(std::memory_order_acquire) || queue.hasData()) {
+            if (!queue.pop(item)) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    while (run.load(std::memory_order_acquire)) { // An observer sees the head and tail at different times.
+        if (queue.freeSpace() > 8) {
+            bounded.store(false, std::memory_order_relaxed);
+        }
+        std::this_thread::yield();
+    }
+
+    producer.join();
+    consumer.join();
+
+    return bounded.load() && queue.freeSpace() == 8;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunCapacityTest() ||
+        !RunOrderTest() ||
+        !RunFreeSpaceTest()) {
+
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}
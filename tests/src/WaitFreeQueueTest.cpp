@@ -0,0 +1,191 @@
+#include <WaitFreeQueue.h>
+#include <QueueTest.h>
+#include <QueueTopology.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+static_assert(QueueEngine<WaitFreeQueue<unsigned long long>>);
+
+std::atomic<bool> stalling{ false };
+std::atomic<bool> stalled{ false };
+thread_local size_t allocationsBeforeStall{ 0 }; // stall the thread at its nth allocation from now, never if 0
+
+/** Count the allocations of the calling thread, so a test can stall it at a chosen point of an operation.
+ */
+void* operator new(size_t size) {
+
+    if (allocationsBeforeStall != 0 && --allocationsBeforeStall == 0) {
+        stalled.store(true, std::memory_order_release);
+        while (stalling.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    return memory;
+}
+
+// Not inlined, or the compiler pairs the free with the new expressions and warns of a mismatch.
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+bool RunBurstTest() {
+
+    WaitFreeQueue<std::string> queue{};
+
+    // Far more than any ring of the other tests holds, and in two bursts so the second follows reclaimed nodes.
+    for (size_t burst = 0; burst < 2; ++burst) {
+
+        for (size_t i = 0; i < 100000; ++i) {
+            queue.push(std::to_string(i));
+        }
+
+        std::string data{};
+        for (size_t i = 0; i < 100000; ++i) {
+            if (!queue.pop(data) || data != std::to_string(i)) {
+                std::cout << "Burst " << burst << " lost the order at " << i << std::endl;
+                return false;
+            }
+        }
+
+        if (queue.pop(data) || queue.hasData()) {
+            return false;
+        }
+    }
+
+    queue.close();
+
+    return !queue.push("closed") && !queue.hasSpace();
+}
+
+bool RunThreadedTest() {
+
+    WaitFreeQueue<unsigned long long> queue{};
+
+    return runProducersConsumers(queue, 4, 4, 200000);
+}
+
+bool RunStalledThreadTest() {
+
+    WaitFreeQueue<unsigned long long> queue{ 4 };
+
+    queue.push(1);
+    queue.push(2);
+
+    std::atomic<unsigned long long> result{ 0 };
+
+    stalling.store(true);
+
+    std::thread consumer([&queue, &result]() {
+        queue.hasData(); // Join the queue, so the allocations of the pop are its own.
+
+        // The first allocation of the pop is its announcement, the second one comes once it is published.
+        allocationsBeforeStall = 2;
+
+        unsigned long long data{};
+        result.store(queue.pop(data) ? data : ~0ULL);
+    });
+
+    while (!stalled.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    // The stalled pop is announced with an older phase: the next pop must complete it too, which leaves nothing.
+    unsigned long long data{};
+    if (!queue.pop(data) || queue.hasData()) {
+        std::cout << "The pop of the stalled thread was not helped" << std::endl;
+        stalling.store(false);
+        consumer.join();
+        return false;
+    }
+
+    unsigned long long first = data;
+    bool inOrder{ true };
+    for (unsigned long long i = 3; i < 1000; ++i) { // The stalled thread holds nobody back.
+        queue.push(i);
+        inOrder = inOrder && queue.pop(data) && data == i;
+    }
+
+    stalling.store(false, std::memory_order_release);
+    consumer.join();
+
+    return inOrder && first + result.load() == 3 && !queue.hasData();
+}
+
+bool RunQueueLifetimeTest() {
+
+    const size_t numberOfThreads{ 4 };
+    const size_t rounds{ 20 };
+
+    // The threads outlive the queues they used, and every new queue has room for exactly the same threads.
+    auto queue = std::make_unique<WaitFreeQueue<unsigned long long>>(numberOfThreads);
+
+    std::atomic<size_t> started{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    std::atomic<size_t> failures{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (size_t thread = 0; thread < numberOfThreads; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (size_t round = 1; round <= rounds; ++round) {
+
+                while (started.load(std::memory_order_acquire) != round) {
+                    std::this_thread::yield();
+                }
+
+                for (unsigned long long i = 0; i < 1000; ++i) {
+                    queue->push(thread);
+                    unsigned long long data{};
+                    if (!queue->pop(data)) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                finished.fetch_add(1, std::memory_order_acq_rel);
+            }
+        });
+    }
+
+    for (size_t round = 1; round <= rounds; ++round) {
+
+        started.store(round, std::memory_order_release);
+
+        while (finished.load(std::memory_order_acquire) != round * numberOfThreads) {
+            std::this_thread::yield();
+        }
+
+        queue = std::make_unique<WaitFreeQueue<unsigned long long>>(numberOfThreads);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return failures.load() == 0;
+}
+
+int main() {
+    std::cout << "Test Started!" << std::endl;
+
+    if (!RunBurstTest() || !RunThreadedTest() || !RunStalledThreadTest() || !RunQueueLifetimeTest()) {
+        std::cout << "Test Failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Passed!" << std::endl;
+    return 0;
+}